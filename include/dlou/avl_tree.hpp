@@ -4,30 +4,31 @@
 
 namespace dlou {
 
-template<class Key, class Compare = std::less<Key>>
+template<class Key, class Compare = std::less<Key>, class Augment = void>
 class avl_tree
-	: public basic_bst<Key, Compare, unsigned char>
+	: public basic_bst<Key, Compare, unsigned char, Augment>
 {
-	using basic_type = basic_bst<Key, Compare, unsigned char>;
+	using basic_type = basic_bst<Key, Compare, unsigned char, Augment>;
 public:
 	using typename basic_type::key_type;
 	using typename basic_type::node;
 	using typename basic_type::iterator;
 
-	using height_type = node_balance_t<node>;
+	using height_type = typename basic_type::balance_type;
 	using balance_type = std::make_signed_t<height_type>;
 
 protected:
 	using basic_type::root_;
 	using basic_type::_parent;
 	using basic_type::_rotate;
+	using basic_type::balance;
 	using basic_type::compare;
 	using basic_type::make_iterator;
 
 protected:
-	static height_type height(node* p) { return p ? p->b : 0; }
+	static height_type height(node* p) { return p ? balance(p) : 0; }
 	static height_type max_hei(height_type a, height_type b) { return a > b ? a : b; }
-	static void reset_hei(node* p) { p->b = 1 + max_hei(height(p->n[0]), height(p->n[1])); }
+	static void reset_hei(node* p) { balance(p) = 1 + max_hei(height(p->n[0]), height(p->n[1])); }
 
 	node* rotate(bool right, node* pos) {
 		const size_t _0 = false == right;
@@ -58,7 +59,7 @@ protected:
 	bool _fault(const node* pos) const {
 		auto h0 = height(pos->n[0]);
 		auto h1 = height(pos->n[1]);
-		if (pos->b != 1 + max_hei(h0, h1))
+		if (balance(pos) != 1 + max_hei(h0, h1))
 			return true;
 
 		balance_type b = h0 - h1;
@@ -75,7 +76,7 @@ protected:
 				return true;
 		}
 
-		return false;
+		return basic_type::_fault_augment(pos);
 	}
 
 public:
@@ -100,7 +101,7 @@ public:
 	}
 
 	iterator insert(node* p) {
-		p->b = 1;
+		balance(p) = 1;
 
 		basic_type::insert(p);
 		node* pos = _parent(p);
@@ -114,7 +115,7 @@ public:
 				break;
 			}
 
-			++pos->b;
+			++basic_type::balance(pos);
 			pos = _parent(pos);
 		}
 
@@ -131,13 +132,13 @@ public:
 			if (1 & balance)
 				break;
 			if (balance) {
-				h0 = parent->b;
+				h0 = basic_type::balance(parent);
 				parent = rotate(0 <= balance, parent);
-				if (h0 == parent->b)
+				if (h0 == basic_type::balance(parent))
 					break;
 			}
 			else
-				--parent->b;
+				--basic_type::balance(parent);
 
 			parent = _parent(parent);
 		}
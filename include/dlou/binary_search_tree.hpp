@@ -1,21 +1,188 @@
 #pragma once
 
+#include "macro.hpp"
 #include "binary_tree.hpp"
 
+#include <cstddef>
+
+#include <limits>
 #include <type_traits>
 #include <functional>
+#ifdef __cpp_concepts
+#include <concepts>
+#endif
 
 namespace dlou {
 
-template<class Key, class Compare = std::less<Key>, class Balance = void>
+namespace _bst {
+	// b : balance of the tree, a : augmented value of the subtree
+	template<class Balance, class Value>
+	struct augmented {
+		Balance b;
+		Value a;
+	};
+
+	template<class Value>
+	struct augmented<void, Value> {
+		Value a;
+	};
+
+	template<class Balance, class Augment>
+	struct balance {
+		using type = augmented<Balance, typename Augment::value_type>;
+	};
+
+	template<class Balance>
+	struct balance<Balance, void> {
+		using type = Balance;
+	};
+
+	template<class Balance, class Augment>
+	using balance_t = typename balance<Balance, Augment>::type;
+
+	template<class Value, class = void>
+	struct equality_comparable : std::false_type {};
+
+	template<class Value>
+	struct equality_comparable<Value, std::void_t<decltype(std::declval<const Value&>() == std::declval<const Value&>())>> : std::true_type {};
+
+	template<class Value>
+	struct value_init {
+		Value operator ()() const { return Value(); }
+	};
+
+	template<class Value>
+	struct lowest {
+		Value operator ()() const { return std::numeric_limits<Value>::lowest(); }
+	};
+
+	template<class Value>
+	struct highest {
+		Value operator ()() const { return std::numeric_limits<Value>::max(); }
+	};
+
+	template<class Value>
+	struct maximum {
+		Value operator ()(const Value& a, const Value& b) const { return a < b ? b : a; }
+	};
+
+	template<class Value>
+	struct minimum {
+		Value operator ()(const Value& a, const Value& b) const { return b < a ? b : a; }
+	};
+
+#ifdef __cpp_concepts
+	template<class Augment>
+	concept counted = requires (const typename Augment::value_type& v)
+	{
+		{ Augment::size(v) } -> std::convertible_to<size_t>;
+	};
+
+	template<class Augment>
+	concept monoid = requires
+	{
+		{ Augment::identity() } -> std::convertible_to<typename Augment::value_type>;
+	};
+
+	template<class Augment, class Key>
+	concept interval = requires (const Key& k, const typename Augment::value_type& v)
+	{
+		{ Augment::start(k) } -> std::convertible_to<typename Augment::value_type>;
+		{ Augment::end(k) } -> std::convertible_to<typename Augment::value_type>;
+		{ v < v } -> std::convertible_to<bool>;
+	};
+#endif//__cpp_concepts
+} // namespace _bst
+
+// augmentation of basic_bst, keeps the node count of each subtree
+// value = combine(combine(left, make(key)), right)
+struct subtree_size {
+	using value_type = size_t;
+
+	template<class Key>
+	static value_type make(const Key&) { return 1; }
+
+	static value_type combine(const value_type& a, const value_type& b) { return a + b; }
+
+	static value_type identity() { return 0; }
+
+	static size_t size(const value_type& v) { return v; }
+};
+
+// augmentation of basic_bst by a monoid over Project(key)
+// Op must be associative, Identity() returns its identity element
+template<class Value
+	, class Project = std::identity
+	, class Op = std::plus<Value>
+	, class Identity = _bst::value_init<Value>>
+struct monoid_augment {
+	using value_type = Value;
+
+	template<class Key>
+	static value_type make(const Key& k) { return Project()(k); }
+
+	static value_type combine(const value_type& a, const value_type& b) { return Op()(a, b); }
+
+	static value_type identity() { return Identity()(); }
+};
+
+template<class Value, class Project = std::identity>
+using subtree_sum = monoid_augment<Value, Project, std::plus<Value>>;
+
+template<class Value, class Project = std::identity>
+using subtree_max = monoid_augment<Value, Project, _bst::maximum<Value>, _bst::lowest<Value>>;
+
+template<class Value, class Project = std::identity>
+using subtree_min = monoid_augment<Value, Project, _bst::minimum<Value>, _bst::highest<Value>>;
+
+// a monoid augmentation with the node count, enables select, rank and distance beside aggregate
+template<class Augment>
+struct counted_augment {
+	struct value_type {
+		size_t size;
+		typename Augment::value_type value;
+
+		bool operator ==(const value_type&) const = default;
+	};
+
+	template<class Key>
+	static value_type make(const Key& k) { return { 1, Augment::make(k) }; }
+
+	static value_type combine(const value_type& a, const value_type& b) {
+		return { a.size + b.size, Augment::combine(a.value, b.value) };
+	}
+
+	static value_type identity() { return { 0, Augment::identity() }; }
+
+	static size_t size(const value_type& v) { return v.size; }
+};
+
+// augmentation of an interval tree, a key is the interval [Start(key), End(key))
+// the tree must be ordered by Start, the value is the maximum End of the subtree
+// enables find_overlap and next_overlap
+template<class Value, class Start, class End>
+struct interval_augment
+	: subtree_max<Value, End>
+{
+	template<class Key>
+	static Value start(const Key& k) { return Start()(k); }
+
+	template<class Key>
+	static Value end(const Key& k) { return End()(k); }
+};
+
+// Augment : void or a policy like subtree_size, the value is kept through rotations, insertions and erasures
+template<class Key, class Compare = std::less<Key>, class Balance = void, class Augment = void>
 class basic_bst
-	: protected binary_tree<Key, Balance>
+	: protected binary_tree<Key, _bst::balance_t<Balance, Augment>>
 	, private Compare
 {
-	using basic_type = binary_tree<Key, Balance>;
+	using basic_type = binary_tree<Key, _bst::balance_t<Balance, Augment>>;
 public:
 	using key_type = Key;
 	using key_compare = Compare;
+	using balance_type = Balance;
+	using augment_type = Augment;
 
 	using typename basic_type::node;
 	using typename basic_type::iterator;
@@ -53,6 +220,78 @@ protected:
 
 	basic_bst(node* p) : basic_type(p) {}
 
+	static decltype(auto) balance(node* p) {
+		if constexpr (std::is_void_v<Augment>)
+			return (p->b);
+		else
+			return (p->b.b);
+	}
+
+	static decltype(auto) balance(const node* p) {
+		if constexpr (std::is_void_v<Augment>)
+			return (p->b);
+		else
+			return (p->b.b);
+	}
+
+	// recompute the augmented value of p from its children
+	static void _update(node* p) {
+		if constexpr (!std::is_void_v<Augment>) {
+			auto v = Augment::make(p->k);
+			if (auto child = p->n[0])
+				v = Augment::combine(child->b.a, v);
+			if (auto child = p->n[1])
+				v = Augment::combine(v, child->b.a);
+			p->b.a = v;
+		}
+	}
+
+	// recompute p and its ancestors
+	static void _update_path(node* p) {
+		if constexpr (!std::is_void_v<Augment>) {
+			while (p) {
+				_update(p);
+				p = _parent(p);
+			}
+		}
+	}
+
+	static size_t _count(const node* p) {
+		return p ? Augment::size(p->b.a) : 0;
+	}
+
+	// the first node in order of the subtree whose interval overlaps [lo, hi)
+	template<class Value>
+	static node* _overlap(node* pos, const Value& lo, const Value& hi) {
+		while (pos) {
+			// an interval on the left ends after lo, either it overlaps or nothing from pos on starts before hi
+			if (auto child = pos->n[0]; child && lo < child->b.a) {
+				pos = child;
+				continue;
+			}
+			if (!(Augment::start(pos->k) < hi))
+				return nullptr;
+			if (lo < Augment::end(pos->k))
+				return pos;
+			pos = pos->n[1];
+		}
+		return nullptr;
+	}
+
+	static bool _fault_augment(const node* pos) {
+		if constexpr (!std::is_void_v<Augment>) {
+			if constexpr (_bst::equality_comparable<typename Augment::value_type>::value) {
+				auto v = Augment::make(pos->k);
+				if (auto child = pos->n[0])
+					v = Augment::combine(child->b.a, v);
+				if (auto child = pos->n[1])
+					v = Augment::combine(v, child->b.a);
+				return !(v == pos->b.a);
+			}
+		}
+		return false;
+	}
+
 	bool _fault(const node* pos) const {
 		if (auto child = pos->n[0])
 			if (pos != _parent(child)
@@ -64,7 +303,7 @@ protected:
 				|| compare(child->k, pos->k))
 				return true;
 		
-		return false;
+		return _fault_augment(pos);
 	}
 
 	static node* _rotate(bool right, node* pos) {
@@ -81,6 +320,12 @@ protected:
 		if (sub)
 			_parent(sub) = pos;
 
+		// par takes the whole subtree of pos
+		if constexpr (!std::is_void_v<Augment>) {
+			par->b.a = pos->b.a;
+			_update(pos);
+		}
+
 		return par;
 	}
 
@@ -172,6 +417,7 @@ protected:
 			_parent(child) = parent;
 
 		*branch = child;
+		_update_path(parent);
 
 		subtree = child;
 		return parent;
@@ -196,6 +442,8 @@ protected:
 			parent->n[pos == parent->n[1]] = child;
 		else
 			root_ = child;
+
+		_update_path(parent);
 	}
 
 public:
@@ -246,6 +494,157 @@ public:
 		return basic_type::in_order::last(const_cast<node*>(root_));
 	}
 
+	// the augmented value of the subtree of p
+	static const auto& augment(const node* p)
+		DLOU_REQUIRES(!std::is_void_v<Augment>) {
+		return p->b.a;
+	}
+
+	// recompute the augmented values from p to the root
+	// after a part of p->k that Augment reads but Compare does not is changed
+	void update(const node* p)
+		DLOU_REQUIRES(!std::is_void_v<Augment>) {
+		_update_path(const_cast<node*>(p));
+	}
+
+	// combine the nodes in [lo, hi) in order, O(log n) on a balanced tree
+	auto aggregate(const key_type& lo, const key_type& hi) const
+		DLOU_REQUIRES(_bst::monoid<Augment>) {
+		// the highest node in [lo, hi) splits the range
+		node* top = root_;
+		while (top) {
+			if (compare(top->k, lo))
+				top = top->n[1];
+			else if (!compare(top->k, hi))
+				top = top->n[0];
+			else
+				break;
+		}
+		if (!top)
+			return Augment::identity();
+
+		// the left subtree, each node >= lo comes with its right subtree
+		auto ret = Augment::identity();
+		for (node* pos = top->n[0]; pos; ) {
+			if (compare(pos->k, lo))
+				pos = pos->n[1];
+			else {
+				auto v = Augment::make(pos->k);
+				if (auto child = pos->n[1])
+					v = Augment::combine(v, child->b.a);
+				ret = Augment::combine(v, ret);
+				pos = pos->n[0];
+			}
+		}
+
+		ret = Augment::combine(ret, Augment::make(top->k));
+
+		// the right subtree, each node < hi comes with its left subtree
+		for (node* pos = top->n[1]; pos; ) {
+			if (!compare(pos->k, hi))
+				pos = pos->n[0];
+			else {
+				auto v = Augment::make(pos->k);
+				if (auto child = pos->n[0])
+					v = Augment::combine(child->b.a, v);
+				ret = Augment::combine(ret, v);
+				pos = pos->n[1];
+			}
+		}
+		return ret;
+	}
+
+	// the first node in order whose interval overlaps [lo, hi), end() if none
+	template<class Value>
+	iterator find_overlap(const Value& lo, const Value& hi) const
+		DLOU_REQUIRES(_bst::interval<Augment, Key>) {
+		return make_iterator(_overlap(root_, lo, hi));
+	}
+
+	// the next node after it whose interval overlaps [lo, hi), end() if none
+	template<class Value>
+	iterator next_overlap(iterator it, const Value& lo, const Value& hi) const
+		DLOU_REQUIRES(_bst::interval<Augment, Key>) {
+		node* pos = const_cast<node*>(&*it);
+		if (node* ret = _overlap(pos->n[1], lo, hi))
+			return make_iterator(ret);
+
+		while (node* parent = _parent(pos)) {
+			if (pos == parent->n[0]) {
+				if (!(Augment::start(parent->k) < hi))
+					break;
+				if (lo < Augment::end(parent->k))
+					return make_iterator(parent);
+				if (node* ret = _overlap(parent->n[1], lo, hi))
+					return make_iterator(ret);
+			}
+			pos = parent;
+		}
+		return end();
+	}
+
+	// O(1)
+	size_t size() const
+		DLOU_REQUIRES(_bst::counted<Augment>) {
+		return _count(root_);
+	}
+
+	// the k-th node in order, end() if k >= size()
+	iterator select(size_t k) const
+		DLOU_REQUIRES(_bst::counted<Augment>) {
+		node* pos = root_;
+		while (pos) {
+			size_t left = _count(pos->n[0]);
+			if (k < left)
+				pos = pos->n[0];
+			else if (k == left)
+				break;
+			else {
+				k -= left + 1;
+				pos = pos->n[1];
+			}
+		}
+		return make_iterator(pos);
+	}
+
+	// the number of nodes less than key, the index of lower_bound(key)
+	size_t rank(const key_type& key) const
+		DLOU_REQUIRES(_bst::counted<Augment>) {
+		node* pos = root_;
+		size_t ret = 0;
+		while (pos) {
+			if (compare(pos->k, key)) {
+				ret += _count(pos->n[0]) + 1;
+				pos = pos->n[1];
+			}
+			else
+				pos = pos->n[0];
+		}
+		return ret;
+	}
+
+	// the in-order index of it, size() for end()
+	size_t index(iterator it) const
+		DLOU_REQUIRES(_bst::counted<Augment>) {
+		if (end() == it)
+			return _count(root_);
+
+		node* pos = const_cast<node*>(&*it);
+		size_t ret = _count(pos->n[0]);
+		while (node* parent = _parent(pos)) {
+			if (pos == parent->n[1])
+				ret += _count(parent->n[0]) + 1;
+			pos = parent;
+		}
+		return ret;
+	}
+
+	// O(log n) on a balanced tree
+	ptrdiff_t distance(iterator first, iterator last) const
+		DLOU_REQUIRES(_bst::counted<Augment>) {
+		return ptrdiff_t(index(last)) - ptrdiff_t(index(first));
+	}
+
 protected:
 	const node* fault() const {
 		using order = typename basic_type::pre_order;
@@ -297,6 +696,7 @@ protected:
 		_parent(p) = parent;
 		p->n[0] = p->n[1] = nullptr;
 		*branch = p;
+		_update_path(p);
 
 		return make_iterator(p);
 	}
@@ -323,11 +723,11 @@ protected:
 	}
 }; // class basic_bst
 
-template<class Key, class Compare = std::less<Key>>
+template<class Key, class Compare = std::less<Key>, class Augment = void>
 class binary_search_tree
-	: public basic_bst<Key, Compare, void>
+	: public basic_bst<Key, Compare, void, Augment>
 {
-	using basic_type = basic_bst<Key, Compare, void>;
+	using basic_type = basic_bst<Key, Compare, void, Augment>;
 public:
 	using basic_type::fault;
 	using basic_type::rotate;
@@ -5,6 +5,13 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <mutex>
+#include <algorithm>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
 namespace dlou {
 
 static constexpr size_t none = ~size_t(0);
@@ -30,6 +37,7 @@ public:
 
 			--val;
 		}
+		free_count_[max_level] = 1;
 	}
 
 	bool empty() const {
@@ -40,6 +48,29 @@ public:
 		return !node_[0];
 	}
 
+	// free blocks of pow2(exp) which can not merge with their buddies
+	size_t free_blocks(uint8_t exp) const {
+		return free_count_[exp];
+	}
+
+	// invalid_exp if full
+	uint8_t largest_free_order() const {
+		return node_[0] - 1;
+	}
+
+	size_t free_units() const {
+		return free_units_;
+	}
+
+	// the most units in use at once
+	size_t high_water() const {
+		return high_water_;
+	}
+
+	void reset_high_water() {
+		high_water_ = max_size - free_units_;
+	}
+
 	// return buffer offset
 	size_t allocate(size_t siz) {
 		return allocate_by_pow2(to_exp(siz));
@@ -53,9 +84,13 @@ public:
 		const auto arr = btree();
 		static constexpr auto beg = root();
 		auto idx = beg; // index
+		uint8_t split = invalid_exp; // order of the free block to split
 
 		uint8_t lval, rval;
 		for (uint8_t level = max_level; level != exp; --level) {
+			if (invalid_exp == split && level + 1 == arr[idx])
+				split = level;
+
 			auto left = to_left(idx);
 			auto right = to_right(idx);
 			lval = arr[left];
@@ -72,6 +107,7 @@ public:
 		}
 
 		arr[idx] = lval = 0;
+		on_allocate(exp, invalid_exp == split ? exp : split);
 
 		size_t pos = get_offset(exp, idx);
 
@@ -95,7 +131,6 @@ public:
 #endif
 
 		const auto arr = btree();
-		static constexpr auto beg = root();
 		static constexpr size_t offset = get_leftmost(0);
 		auto idx = offset + pos;
 		uint8_t cval = 1; // current value
@@ -103,35 +138,14 @@ public:
 		while(arr[idx]) {
 #ifdef DLOU_CHECK_ARGS
 			// not found
-			if (beg == idx)
+			if (root() == idx)
 				return;
 #endif
 			idx = to_parent(idx);
 			++cval;
 		}
 
-		arr[idx] = cval;
-
-		uint8_t bval; // buddy value
-
-		while (beg != idx) {
-			bval = arr[to_buddy(idx)];
-			idx = to_parent(idx);
-			// cval is max value for this level
-			if (cval != bval) {
-				arr[idx] = cval;
-
-				while (idx) {
-					bval = arr[to_buddy(idx)];
-					idx = to_parent(idx);
-					if (cval < bval)
-						return;
-					arr[idx] = cval;
-				}
-				return;
-			}
-			arr[idx] = ++cval;
-		}
+		free_node(idx, cval);
 	}
 
 	void release(size_t pos, size_t siz) {
@@ -150,18 +164,202 @@ public:
 			return;
 #endif
 
-		const auto arr = btree();
-		static constexpr auto beg = root();
 		auto idx = get_leftmost(exp) + (pos >> exp);
-		uint8_t cval = exp + 1; // current value
 
 #ifdef DLOU_CHECK_ARGS
+		const auto arr = btree();
 		if ((0 != arr[idx])
 			|| (0 != exp
 				&& 0 == arr[to_left(idx)]))
 			return;
 #endif
 
+		free_node(idx, exp + 1);
+	}
+
+	// allocate up to count blocks of pow2(exp) by one walk
+	// return the number of allocated blocks
+	size_t allocate_many(uint8_t exp, size_t count, size_t* out) {
+		if (!count || exp >= node_[0])
+			return 0;
+
+		const auto arr = btree();
+		static constexpr auto beg = root();
+		auto idx = beg;
+		uint8_t level = max_level;
+		size_t n = 0;
+
+		for (;;) {
+			uint8_t split = invalid_exp;
+			for (; level != exp; --level) {
+				if (invalid_exp == split && level + 1 == arr[idx])
+					split = level;
+				auto left = to_left(idx);
+				idx = (exp < arr[left]) ? left : to_right(idx);
+			}
+
+			arr[idx] = 0;
+			on_allocate(exp, invalid_exp == split ? exp : split);
+			out[n++] = get_offset(exp, idx);
+
+			// fix ancestors until one has a free block again
+			for (;;) {
+				if (beg == idx)
+					return n;
+				idx = to_parent(idx);
+				++level;
+				arr[idx] = std::max(arr[to_left(idx)], arr[to_right(idx)]);
+				if (n < count && exp < arr[idx])
+					break;
+			}
+		}
+	}
+
+	// release blocks of pow2(exp), ancestors are updated once per level
+	void release_many(const size_t* pos, size_t count, uint8_t exp) {
+#ifdef DLOU_CHECK_ARGS
+		if (exp > max_level)
+			return;
+#endif
+		static constexpr size_t chunk = 64;
+		const auto arr = btree();
+		size_t idx[chunk];
+
+		while (count) {
+			size_t n = count < chunk ? count : chunk;
+			for (size_t i = 0; i < n; ++i) {
+				idx[i] = get_leftmost(exp) + (pos[i] >> exp);
+				arr[idx[i]] = exp + 1;
+			}
+			free_units_ += n << exp;
+			free_count_[exp] += n;
+			pos += n;
+			count -= n;
+			std::sort(idx, idx + n);
+
+			// idx[] are nodes of level whose value changed
+			for (uint8_t level = exp; n && level != max_level; ++level) {
+				const uint8_t full = level + 1;
+				size_t m = 0;
+				for (size_t i = 0; i < n; ++i) {
+					const auto parent = to_parent(idx[i]);
+					if (m && idx[m - 1] == parent)
+						continue;
+
+					const auto lval = arr[to_left(parent)];
+					const auto rval = arr[to_right(parent)];
+					const bool merge = full == lval && full == rval;
+					const uint8_t val = merge ? full + 1 : std::max(lval, rval);
+					if (arr[parent] != val) {
+						arr[parent] = val;
+						idx[m++] = parent;
+						if (merge) {
+							free_count_[level] -= 2;
+							++free_count_[level + 1];
+						}
+					}
+				}
+				n = m;
+			}
+		}
+	}
+
+#ifdef __cpp_lib_span
+	size_t allocate_many(uint8_t exp, std::span<size_t> out) {
+		return allocate_many(exp, out.size(), out.data());
+	}
+
+	void release_many(std::span<const size_t> pos, uint8_t exp) {
+		release_many(pos.data(), pos.size(), exp);
+	}
+#endif//__cpp_lib_span
+
+	// grow the block of allocate_by_pow2(old_exp) to pow2(new_exp) in place if its buddies are free
+	bool try_grow(size_t pos, uint8_t old_exp, uint8_t new_exp) {
+#ifdef DLOU_CHECK_ARGS
+		if (max_size <= pos
+			|| old_exp > new_exp
+			|| new_exp > max_level)
+			return false;
+#endif
+		// the block must be the left part of the new one
+		if (~(~size_t(0) << new_exp) & pos)
+			return false;
+
+		const auto arr = btree();
+		static constexpr auto beg = root();
+		const auto first = get_leftmost(old_exp) + (pos >> old_exp);
+		auto idx = first;
+
+#ifdef DLOU_CHECK_ARGS
+		// the block must be allocated as a whole, like release_by_pow2
+		if ((0 != arr[first])
+			|| (0 != old_exp
+				&& 0 == arr[to_left(first)]))
+			return false;
+		// and every ancestor must have free space if it grows
+		if (old_exp != new_exp) {
+			for (auto i = first; beg != i;) {
+				i = to_parent(i);
+				if (0 == arr[i])
+					return false;
+			}
+		}
+#endif
+
+		for (uint8_t level = old_exp; level != new_exp; ++level) {
+			if (level + 1 != arr[to_buddy(idx)])
+				return false;
+			idx = to_parent(idx);
+		}
+
+		// restore the old block and the inner nodes as free
+		idx = first;
+		for (uint8_t level = old_exp; level != new_exp; ++level) {
+			arr[idx] = level + 1;
+			idx = to_parent(idx);
+			--free_count_[level];
+		}
+		arr[idx] = 0;
+		free_units_ -= (size_t(1) << new_exp) - (size_t(1) << old_exp);
+		update_high_water();
+
+		while (beg != idx) {
+			idx = to_parent(idx);
+			arr[idx] = std::max(arr[to_left(idx)], arr[to_right(idx)]);
+		}
+		return true;
+	}
+
+protected:
+	static constexpr uint8_t to_exp(size_t siz) {
+		return
+#ifdef DLOU_CHECK_ARGS
+		(!siz) ? uint8_t(0) :
+#endif
+			(base2::log(siz) + !base2::ispow(siz));
+	}
+
+	void update_high_water() {
+		const size_t used = max_size - free_units_;
+		if (high_water_ < used)
+			high_water_ = used;
+	}
+
+	// a block of pow2(exp) is split from a free block of pow2(split)
+	void on_allocate(uint8_t exp, uint8_t split) {
+		--free_count_[split];
+		for (uint8_t i = exp; i < split; ++i)
+			++free_count_[i];
+		free_units_ -= size_t(1) << exp;
+		update_high_water();
+	}
+
+	// mark node idx of value cval free and merge with the free buddies
+	void free_node(size_t idx, uint8_t cval) {
+		const auto arr = btree();
+		static constexpr auto beg = root();
+		free_units_ += size_t(1) << (cval - 1);
 		arr[idx] = cval;
 
 		uint8_t bval; // buddy value
@@ -169,30 +367,23 @@ public:
 		while (beg != idx) {
 			bval = arr[to_buddy(idx)];
 			idx = to_parent(idx);
-			// cval is max value for level
+			// cval is max value for this level
 			if (cval != bval) {
 				arr[idx] = cval;
 
-				while (idx) {
+				while (beg != idx) {
 					bval = arr[to_buddy(idx)];
 					idx = to_parent(idx);
 					if (cval < bval)
-						return;
+						break;
 					arr[idx] = cval;
 				}
-				return;
+				break;
 			}
+			--free_count_[cval - 1];
 			arr[idx] = ++cval;
 		}
-	}
-
-protected:
-	static constexpr uint8_t to_exp(size_t siz) {
-		return
-#ifdef DLOU_CHECK_ARGS
-		(!siz) ? uint8_t(0) :
-#endif
-			(base2::log(siz) + !base2::ispow(siz));
+		++free_count_[cval - 1];
 	}
 
 	// 1-based indexing
@@ -231,10 +422,236 @@ protected:
 
 private:
 	uint8_t node_[node_count];
+	size_t free_count_[max_level + 1] = {};
+	size_t free_units_ = max_size;
+	size_t high_water_ = 0;
+};
+
+
+namespace _buddy {
+
+// words of a bitmap level
+static constexpr size_t word_bits = 64;
+static constexpr size_t to_words(size_t bits) { return (bits + word_bits - 1) / word_bits; }
+
+template<uint8_t Level>
+struct bitmap_layout {
+	// bitmap levels of the largest order 0 bitmap
+	static constexpr uint8_t max_depth = Level / 6 + 1;
+
+	size_t free_offset[Level + 1][max_depth] = {};
+	uint8_t free_depth[Level + 1] = {};
+	size_t alloc_offset[Level + 1] = {};
+	size_t free_words = 0;
+	size_t alloc_words = 0;
+
+	constexpr bitmap_layout() {
+		for (uint8_t exp = 0; exp <= Level; ++exp) {
+			size_t bits = size_t(1) << (Level - exp);
+			alloc_offset[exp] = alloc_words;
+			alloc_words += to_words(bits);
+
+			uint8_t depth = 0;
+			do {
+				bits = to_words(bits);
+				free_offset[exp][depth++] = free_words;
+				free_words += bits;
+			} while (1 < bits);
+			free_depth[exp] = depth;
+		}
+	}
+};
+
+} // namespace _buddy
+
+
+// buddy with one free bitmap per order
+// a summary bitmap level over every 64 words, the top word of each order is a bit of orders_
+template<uint8_t Level>
+class bitmap_buddy
+{
+	static_assert(Level < 64, "Check bitmap_buddy template args");
+
+	using word_type = uint64_t;
+	static constexpr _buddy::bitmap_layout<Level> layout{};
+
+public:
+	static constexpr uint8_t max_level = Level;
+	static constexpr size_t max_size = size_t(1) << max_level;
+
+public:
+	bitmap_buddy() {
+		set_free(max_level, 0);
+	}
+
+	bool empty() const {
+		return (orders_ >> max_level) & 1;
+	}
+
+	bool full() const {
+		return !orders_;
+	}
+
+	// free blocks of pow2(exp) which can not merge with their buddies
+	size_t free_blocks(uint8_t exp) const {
+		return free_count_[exp];
+	}
+
+	// invalid_exp if full
+	uint8_t largest_free_order() const {
+		return orders_ ? bit::bsr(orders_) : invalid_exp;
+	}
+
+	size_t free_units() const {
+		return free_units_;
+	}
+
+	// the most units in use at once
+	size_t high_water() const {
+		return high_water_;
+	}
+
+	void reset_high_water() {
+		high_water_ = max_size - free_units_;
+	}
+
+	// return buffer offset
+	size_t allocate(size_t siz) {
+		return allocate_by_pow2(to_exp(siz));
+	}
+
+	// same allocate(pow2(exp))
+	size_t allocate_by_pow2(uint8_t exp) {
+		if (exp > max_level)
+			return none;
+		const word_type mask = orders_ >> exp;
+		if (!mask)
+			return none;
+
+		// smallest free order >= exp
+		uint8_t cur = exp + bit::bsf(mask);
+		size_t idx = find_free(cur);
+		reset_free(cur, idx);
+
+		// split, keep the left half and free the right half
+		while (cur != exp) {
+			--cur;
+			idx <<= 1;
+			set_free(cur, idx | 1);
+		}
+
+		set_bit(alloc_ + layout.alloc_offset[exp], idx);
+		free_units_ -= size_t(1) << exp;
+		if (high_water_ < max_size - free_units_)
+			high_water_ = max_size - free_units_;
+		return idx << exp;
+	}
+
+	void release(size_t pos) {
+#ifdef DLOU_CHECK_ARGS
+		if (max_size <= pos)
+			return;
+#endif
+		for (uint8_t exp = 0; exp <= max_level; ++exp) {
+			const size_t idx = pos >> exp;
+			if (test_bit(alloc_ + layout.alloc_offset[exp], idx))
+				return release_by_pow2(pos, exp);
+			// not found
+			if (idx & 1)
+				return;
+		}
+	}
+
+	void release(size_t pos, size_t siz) {
+#ifdef DLOU_CHECK_ARGS
+		if (!base2::ispow(siz))
+			return;
+#endif
+		return release_by_pow2(pos, base2::log(siz));
+	}
+
+	void release_by_pow2(size_t pos, uint8_t exp) {
+		size_t idx = pos >> exp;
+#ifdef DLOU_CHECK_ARGS
+		if (max_size <= pos
+			|| exp > max_level
+			|| ~(~size_t(0) << exp) & pos
+			|| !test_bit(alloc_ + layout.alloc_offset[exp], idx))
+			return;
+#endif
+		reset_bit(alloc_ + layout.alloc_offset[exp], idx);
+		free_units_ += size_t(1) << exp;
+
+		// merge with the free buddies
+		while (exp < max_level && test_bit(free_ + layout.free_offset[exp][0], idx ^ 1)) {
+			reset_free(exp, idx ^ 1);
+			idx >>= 1;
+			++exp;
+		}
+		set_free(exp, idx);
+	}
+
+protected:
+	static constexpr uint8_t to_exp(size_t siz) {
+		return
+#ifdef DLOU_CHECK_ARGS
+		(!siz) ? uint8_t(0) :
+#endif
+			(base2::log(siz) + !base2::ispow(siz));
+	}
+
+	static constexpr word_type to_bit(size_t idx) { return word_type(1) << (idx % _buddy::word_bits); }
+	static constexpr bool test_bit(const word_type* p, size_t idx) { return p[idx / _buddy::word_bits] & to_bit(idx); }
+	static constexpr void set_bit(word_type* p, size_t idx) { p[idx / _buddy::word_bits] |= to_bit(idx); }
+	static constexpr void reset_bit(word_type* p, size_t idx) { p[idx / _buddy::word_bits] &= ~to_bit(idx); }
+
+	// descend the summary levels by bsf
+	size_t find_free(uint8_t exp) const {
+		const auto* offset = layout.free_offset[exp];
+		size_t idx = 0;
+		for (uint8_t d = layout.free_depth[exp]; d--;)
+			idx = idx * _buddy::word_bits + bit::bsf(free_[offset[d] + idx]);
+		return idx;
+	}
+
+	void set_free(uint8_t exp, size_t idx) {
+		++free_count_[exp];
+		const auto* offset = layout.free_offset[exp];
+		for (uint8_t d = 0; d < layout.free_depth[exp]; ++d) {
+			auto& word = free_[offset[d] + idx / _buddy::word_bits];
+			const bool used = 0 != word;
+			word |= to_bit(idx);
+			if (used)
+				return;
+			idx /= _buddy::word_bits;
+		}
+		orders_ |= word_type(1) << exp;
+	}
+
+	void reset_free(uint8_t exp, size_t idx) {
+		--free_count_[exp];
+		const auto* offset = layout.free_offset[exp];
+		for (uint8_t d = 0; d < layout.free_depth[exp]; ++d) {
+			auto& word = free_[offset[d] + idx / _buddy::word_bits];
+			word &= ~to_bit(idx);
+			if (word)
+				return;
+			idx /= _buddy::word_bits;
+		}
+		orders_ &= ~(word_type(1) << exp);
+	}
+
+private:
+	word_type orders_ = 0;
+	word_type free_[layout.free_words] = {};
+	word_type alloc_[layout.alloc_words] = {};
+	size_t free_count_[max_level + 1] = {};
+	size_t free_units_ = max_size;
+	size_t high_water_ = 0;
 };
 
 
-template<size_t MinSize, size_t MaxSize>
+template<size_t MinSize, size_t MaxSize, template<uint8_t> class Base = buddy>
 class simple_buddy
 {
 	static_assert(MaxSize >= MinSize, "Check simple_buddy template args");
@@ -254,9 +671,26 @@ public:
 	bool empty() const { return base_.empty(); }
 	bool full() const { return base_.full(); }
 
+	size_t free_size() const { return base_.free_units() * min_size; }
+	size_t high_water() const { return base_.high_water() * min_size; }
+	void reset_high_water() { base_.reset_high_water(); }
+
+	size_t largest_free_size() const {
+		auto exp = base_.largest_free_order();
+		return invalid_exp == exp ? 0 : (min_size << exp);
+	}
+
+	// bytes allocated but not requested
+	// estimated if blocks are released without size
+	size_t internal_fragmentation() const { return waste_; }
+
 	size_t allocate(size_t siz) {
+		const auto units = base_.free_units();
 		auto ret = base_.allocate(unit(siz));
-		return ret == none ? none : (ret * min_size);
+		if (ret == none)
+			return none;
+		waste_ += (units - base_.free_units()) * min_size - siz;
+		return ret * min_size;
 	}
 
 	void release(size_t pos) {
@@ -265,22 +699,182 @@ public:
 		if (pos != new_pos * min_size)
 			return;
 #endif
+		const auto units = base_.free_units();
 		base_.release(new_pos);
+		// waste of the block is unknown, take the average
+		const auto used = (max_size / min_size) - units;
+		if (used)
+			waste_ -= static_cast<size_t>(static_cast<double>(waste_) * (base_.free_units() - units) / used);
 	}
 
 	void release(size_t pos, size_t siz) {
 		size_t new_pos = pos / min_size;
-		size_t new_siz = siz / min_size;
 #ifdef DLOU_CHECK_ARGS
-		if (pos != new_pos * min_size
-			|| siz != new_siz * min_size)
+		if (pos != new_pos * min_size)
 			return;
 #endif
-		base_.release(new_pos, new_siz);
+		const auto units = base_.free_units();
+		// same block size as allocate(siz)
+		base_.release_by_pow2(new_pos, to_exp(unit(siz)));
+		const auto freed = (base_.free_units() - units) * min_size;
+		if (freed)
+			waste_ -= freed - siz;
+	}
+
+private:
+	Base<max_level> base_;
+	size_t waste_ = 0;
+};
+
+
+// thread-safe buddy
+// shared tree is guarded by a mutex,
+// cache keeps free blocks of small orders for one thread and exchanges them with the tree in batches
+template<uint8_t Level, uint8_t CacheOrders = 4, size_t CacheSize = 32>
+class concurrent_buddy
+{
+	static_assert(CacheOrders <= Level + 1 && CacheSize >= 2, "Check concurrent_buddy template args");
+
+	static constexpr uint8_t to_exp(size_t siz) {
+		return
+#ifdef DLOU_CHECK_ARGS
+		(!siz) ? uint8_t(0) :
+#endif
+			(base2::log(siz) + !base2::ispow(siz));
+	}
+public:
+	using buddy_type = buddy<Level>;
+
+	static constexpr uint8_t max_level = Level;
+	static constexpr size_t max_size = buddy_type::max_size;
+	static constexpr uint8_t cache_orders = CacheOrders;
+	static constexpr size_t cache_size = CacheSize;
+	static constexpr size_t batch_size = CacheSize / 2;
+
+	// per-thread front end, must not be shared between threads
+	class cache
+	{
+	public:
+		explicit cache(concurrent_buddy& owner) : owner_(owner) {}
+		cache(const cache&) = delete;
+		cache& operator =(const cache&) = delete;
+
+		~cache() {
+			flush();
+		}
+
+		size_t allocate(size_t siz) {
+			return allocate_by_pow2(to_exp(siz));
+		}
+
+		size_t allocate_by_pow2(uint8_t exp) {
+			if (exp >= cache_orders)
+				return owner_.allocate_by_pow2(exp);
+
+			auto& n = count_[exp];
+			if (!n) {
+				n = owner_.refill(exp, free_[exp]);
+				if (!n) {
+					// cached blocks of other orders may merge into a free one
+					flush();
+					n = owner_.refill(exp, free_[exp]);
+					if (!n)
+						return none;
+				}
+			}
+			return free_[exp][--n];
+		}
+
+		void release_by_pow2(size_t pos, uint8_t exp) {
+			if (exp >= cache_orders)
+				return owner_.release_by_pow2(pos, exp);
+
+			auto& n = count_[exp];
+			if (cache_size == n) {
+				n -= batch_size;
+				owner_.flush(exp, free_[exp] + n, batch_size);
+			}
+			free_[exp][n++] = pos;
+		}
+
+		void release(size_t pos, size_t siz) {
+#ifdef DLOU_CHECK_ARGS
+			if (!base2::ispow(siz))
+				return;
+#endif
+			release_by_pow2(pos, base2::log(siz));
+		}
+
+		// return all cached blocks to the shared tree
+		void flush() {
+			std::lock_guard<std::mutex> lock(owner_.mtx_);
+			for (uint8_t exp = 0; exp < cache_orders; ++exp) {
+				owner_.base_.release_many(free_[exp], count_[exp], exp);
+				count_[exp] = 0;
+			}
+		}
+
+	private:
+		concurrent_buddy& owner_;
+		size_t count_[cache_orders] = {};
+		size_t free_[cache_orders][cache_size];
+	};
+
+public:
+	concurrent_buddy() = default;
+	concurrent_buddy(const concurrent_buddy&) = delete;
+	concurrent_buddy& operator =(const concurrent_buddy&) = delete;
+
+	// blocks in caches are counted as allocated
+	bool empty() const {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return base_.empty();
+	}
+
+	bool full() const {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return base_.full();
+	}
+
+	size_t allocate(size_t siz) {
+		return allocate_by_pow2(to_exp(siz));
+	}
+
+	size_t allocate_by_pow2(uint8_t exp) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return base_.allocate_by_pow2(exp);
+	}
+
+	void release(size_t pos) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		base_.release(pos);
+	}
+
+	void release(size_t pos, size_t siz) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		base_.release(pos, siz);
+	}
+
+	void release_by_pow2(size_t pos, uint8_t exp) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		base_.release_by_pow2(pos, exp);
+	}
+
+private:
+	// allocate up to batch_size blocks under one lock
+	size_t refill(uint8_t exp, size_t* out) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		return base_.allocate_many(exp, batch_size, out);
+	}
+
+	void flush(uint8_t exp, const size_t* p, size_t n) {
+		std::lock_guard<std::mutex> lock(mtx_);
+		base_.release_many(p, n, exp);
 	}
 
 private:
-	buddy<max_level> base_;
+	mutable std::mutex mtx_;
+	buddy_type base_;
 };
 
 } // namespace dlou
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "buddy.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+#include <memory_resource>
+
+#ifdef _WIN32
+// keep min / max macros and the rarely used headers out of the including code
+#ifndef NOMINMAX
+#define NOMINMAX
+#define DLOU_UNDEF_NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define DLOU_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef DLOU_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef DLOU_UNDEF_NOMINMAX
+#endif
+#ifdef DLOU_UNDEF_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef DLOU_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#else
+#include <sys/mman.h>
+#endif
+
+namespace dlou {
+
+namespace _buddy_resource {
+
+// the alignment of a mapped arena
+static constexpr size_t page_size = 4096;
+
+inline void* map(size_t siz)
+{
+#ifdef _WIN32
+	return VirtualAlloc(nullptr, siz, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+	void* ret = mmap(nullptr, siz, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return MAP_FAILED == ret ? nullptr : ret;
+#endif
+}
+
+inline void unmap(void* p, size_t siz)
+{
+#ifdef _WIN32
+	(void)siz;
+	VirtualFree(p, 0, MEM_RELEASE);
+#else
+	munmap(p, siz);
+#endif
+}
+
+} // namespace _buddy_resource
+
+
+// std::pmr::memory_resource over chained arenas of simple_buddy<MinSize, MaxSize>
+// not thread-safe
+template<size_t MinSize, size_t MaxSize>
+class buddy_resource : public std::pmr::memory_resource
+{
+public:
+	using buddy_type = simple_buddy<MinSize, MaxSize>;
+
+	static constexpr size_t min_size = buddy_type::min_size;
+	static constexpr size_t max_size = buddy_type::max_size;
+	static constexpr size_t arena_size = max_size;
+	static constexpr size_t max_align = arena_size < _buddy_resource::page_size ? arena_size : _buddy_resource::page_size;
+
+	// blocks sit at multiples of min_size << exp, a power of two keeps them aligned
+	static_assert(base2::ispow(min_size), "buddy_resource requires a power of two MinSize");
+
+private:
+	struct arena {
+		buddy_type buddy;
+		char* base;
+		arena* next;
+	};
+
+public:
+	buddy_resource() = default;
+	buddy_resource(const buddy_resource&) = delete;
+	buddy_resource& operator =(const buddy_resource&) = delete;
+
+	~buddy_resource() override {
+		release();
+	}
+
+	// unmap all arenas, even if blocks are still in use
+	void release() {
+		while (head_) {
+			auto next = head_->next;
+			_buddy_resource::unmap(head_->base, arena_size);
+			delete head_;
+			head_ = next;
+		}
+	}
+
+	size_t arena_count() const {
+		size_t ret = 0;
+		for (auto a = head_; a; a = a->next)
+			++ret;
+		return ret;
+	}
+
+	bool owns(const void* p) const {
+		return nullptr != find(p);
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		// a block is aligned to its size within the arena
+		const size_t siz = bytes < alignment ? alignment : bytes;
+		if (max_size < siz || max_align < alignment)
+			throw std::bad_alloc();
+
+		for (auto a = head_; a; a = a->next) {
+			auto pos = a->buddy.allocate(siz);
+			if (none != pos)
+				return a->base + pos;
+		}
+
+		auto a = new_arena();
+		return a->base + a->buddy.allocate(siz);
+	}
+
+	void do_deallocate(void* p, size_t, size_t) override {
+		auto a = find(p);
+#ifdef DLOU_CHECK_ARGS
+		if (!a)
+			return;
+#endif
+		a->buddy.release(static_cast<char*>(p) - a->base);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& x) const noexcept override {
+		return this == &x;
+	}
+
+private:
+	arena* find(const void* p) const {
+		auto c = static_cast<const char*>(p);
+		for (auto a = head_; a; a = a->next) {
+			if (a->base <= c && c < a->base + arena_size)
+				return a;
+		}
+		return nullptr;
+	}
+
+	// the newest arena is the first one to try
+	arena* new_arena() {
+		auto a = new arena;
+		a->base = static_cast<char*>(_buddy_resource::map(arena_size));
+		if (!a->base) {
+			delete a;
+			throw std::bad_alloc();
+		}
+		a->next = head_;
+		head_ = a;
+		return a;
+	}
+
+private:
+	arena* head_ = nullptr;
+};
+
+} // namespace dlou
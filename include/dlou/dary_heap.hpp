@@ -0,0 +1,232 @@
+#pragma once
+
+#include "node.hpp"
+
+#include <cstddef>
+
+#include <vector>
+#include <type_traits>
+#include <functional>
+
+namespace dlou {
+
+// i : position in the heap array
+template<class Key>
+struct dary_heap_node {
+	Key k;
+	size_t i;
+};
+
+template<class Key>
+struct node_key<dary_heap_node<Key>> {
+	using type = Key;
+
+	Key& operator ()(dary_heap_node<Key>& x) const {
+		return x.k;
+	}
+
+	const Key& operator ()(const dary_heap_node<Key>& x) const {
+		return x.k;
+	}
+};
+
+// implicit heap of node pointers with Arity children per slot
+// a wide heap is shallow and the children of a slot are adjacent, so pop touches fewer cache lines than a binary heap
+template<class NodeKey
+	, size_t Arity = 4
+	, class GetKey = node_key<dary_heap_node<NodeKey>>
+	, class Compare = std::less<std::remove_cvref_t<std::invoke_result_t<GetKey, const dary_heap_node<NodeKey>&>>>>
+class basic_dary_heap
+	: private GetKey
+	, private Compare
+{
+	static_assert(Arity >= 2, "Check basic_dary_heap template args");
+
+public:
+	using node = dary_heap_node<NodeKey>;
+	using key_type = std::remove_cvref_t<std::invoke_result_t<GetKey, const node&>>;
+	using key_compare = Compare;
+
+	static constexpr size_t arity = Arity;
+
+protected:
+	basic_dary_heap(const basic_dary_heap&) = default;
+	basic_dary_heap& operator =(const basic_dary_heap&) = default;
+
+	basic_dary_heap& operator =(basic_dary_heap&& x) {
+		heap_ = std::move(x.heap_);
+		x.heap_.clear();
+		return *this;
+	}
+
+	void clear() {
+		heap_.clear();
+	}
+
+	const key_type& key(const node& n) const {
+		return GetKey::operator ()(n);
+	}
+
+	bool compare(const node& a, const node& b) const {
+		return Compare::operator ()(key(a), key(b));
+	}
+
+	static size_t parent(size_t i) { return (i - 1) / Arity; }
+	static size_t first_child(size_t i) { return i * Arity + 1; }
+
+public:
+	basic_dary_heap() = default;
+
+	basic_dary_heap(basic_dary_heap&& x)
+		: heap_(std::move(x.heap_)) {
+		x.heap_.clear();
+	}
+
+	void swap(basic_dary_heap& x) {
+		heap_.swap(x.heap_);
+	}
+
+	bool empty() const {
+		return heap_.empty();
+	}
+
+	size_t size() const {
+		return heap_.size();
+	}
+
+	void reserve(size_t n) {
+		heap_.reserve(n);
+	}
+
+	void merge(basic_dary_heap& x) {
+		if (x.heap_.empty())
+			return;
+
+		// few nodes: sift each up, otherwise rebuild bottom-up in O(n)
+		if (x.heap_.size() * Arity < heap_.size()) {
+			for (auto p : x.heap_)
+				push(p);
+		}
+		else {
+			heap_.insert(heap_.end(), x.heap_.begin(), x.heap_.end());
+			for (size_t i = heap_.size(); i--; )
+				heap_[i]->i = i;
+			// the last parent is parent(size - 1)
+			if (heap_.size() > 1) {
+				for (size_t i = (heap_.size() - 2) / Arity + 1; i--; )
+					sift_down(i);
+			}
+		}
+		x.heap_.clear();
+	}
+
+	const node* peek() const {
+		return heap_.empty() ? nullptr : heap_.front();
+	}
+
+	void push(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		heap_.push_back(p);
+		sift_up(heap_.size() - 1);
+	}
+
+	node* pop() {
+#ifdef DLOU_CHECK_ARGS
+		if (heap_.empty())
+			return nullptr;
+#endif
+		node* ret = heap_.front();
+		node* last = heap_.back();
+		heap_.pop_back();
+		if (!heap_.empty()) {
+			heap_.front() = last;
+			sift_down(0);
+		}
+		return ret;
+	}
+
+	void erase(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		const size_t i = p->i;
+		node* last = heap_.back();
+		heap_.pop_back();
+		if (p != last) {
+			(heap_[i] = last)->i = i;
+			update(last);
+		}
+	}
+
+	// restore the order after the key of p moved toward the top
+	void decrease(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		sift_up(p->i);
+	}
+
+	// restore the order after the key of p changed in either direction
+	void update(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		const size_t i = p->i;
+		sift_up(i);
+		if (p == heap_[i])
+			sift_down(i);
+	}
+
+protected:
+	// move heap_[i] up to its place
+	void sift_up(size_t i) {
+		node* p = heap_[i];
+		while (i) {
+			size_t up = parent(i);
+			if (!compare(*p, *heap_[up]))
+				break;
+			(heap_[i] = heap_[up])->i = i;
+			i = up;
+		}
+		(heap_[i] = p)->i = i;
+	}
+
+	// move heap_[i] down to its place
+	void sift_down(size_t i) {
+		node* p = heap_[i];
+		const size_t siz = heap_.size();
+		for (;;) {
+			size_t c = first_child(i);
+			if (c >= siz)
+				break;
+
+			// the best of up to Arity adjacent children
+			size_t best = c;
+			const size_t end = siz - c < Arity ? siz : c + Arity;
+			for (++c; c < end; ++c) {
+				if (compare(*heap_[c], *heap_[best]))
+					best = c;
+			}
+
+			if (!compare(*heap_[best], *p))
+				break;
+			(heap_[i] = heap_[best])->i = i;
+			i = best;
+		}
+		(heap_[i] = p)->i = i;
+	}
+
+protected:
+	std::vector<node*> heap_;
+};
+
+template<class Key, class Compare = std::less<Key>, size_t Arity = 4>
+using dary_heap = basic_dary_heap<Key, Arity, node_key<dary_heap_node<Key>>, Compare>;
+
+} // namespace dlou
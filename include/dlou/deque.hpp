@@ -2,10 +2,13 @@
 
 #include "macro.hpp"
 #include "static.hpp"
+#include "integer.hpp"
 #include "xor_linked_list.hpp"
 
 #include <cstddef>
+#include <cstdint>
 
+#include <atomic>
 #include <type_traits>
 #ifdef __cpp_concepts
 #include <concepts>
@@ -34,6 +37,33 @@ namespace _deque {
 		{ list.pop_back() } -> std::same_as<typename Container::node*>;
 	};
 #endif//__cpp_concepts
+
+	// circular array of pointers for work_stealing_deque
+	// replaced arrays are kept until the deque is destroyed, thieves may still read them
+	template<class T>
+	struct ring {
+		const size_t mask;
+		ring* const prev;
+		std::atomic<T*>* const slots;
+
+		ring(size_t capacity, ring* prv)
+			: mask(capacity - 1), prev(prv), slots(new std::atomic<T*>[capacity]) {
+		}
+
+		~ring() {
+			delete[] slots;
+		}
+
+		size_t capacity() const { return mask + 1; }
+
+		T* get(int64_t i) const {
+			return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed);
+		}
+
+		void put(int64_t i, T* p) {
+			slots[static_cast<size_t>(i) & mask].store(p, std::memory_order_relaxed);
+		}
+	};
 } // namespace _deque
 
 
@@ -91,4 +121,126 @@ private:
 	container_type list_;
 };
 
+
+// work-stealing deque of object pointers (Chase-Lev)
+// the owner thread pushes and pops at the back, any thread may steal from the front
+// the circular array doubles when full and never shrinks
+template<class T>
+class work_stealing_deque
+{
+public:
+	using value_type = T;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+
+private:
+	using ring = _deque::ring<T>;
+
+	// copy [t, b) into an array twice as large
+	ring* grow(ring* a, int64_t t, int64_t b) {
+		auto ret = new ring(a->capacity() * 2, a);
+		for (auto i = t; i != b; ++i)
+			ret->put(i, a->get(i));
+		array_.store(ret, std::memory_order_release);
+		return ret;
+	}
+
+public:
+	// capacity - initial capacity, rounded up to 2^n
+	explicit work_stealing_deque(size_t capacity = 64)
+		: array_(new ring(base2::ceil(capacity < 2 ? size_t(2) : capacity), nullptr)) {
+	}
+
+	work_stealing_deque(const work_stealing_deque&) = delete;
+	work_stealing_deque& operator =(const work_stealing_deque&) = delete;
+
+	~work_stealing_deque() {
+		auto a = array_.load(std::memory_order_relaxed);
+		while (a) {
+			auto prv = a->prev;
+			delete a;
+			a = prv;
+		}
+	}
+
+	// approximate unless called by the owner while no thread steals
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// approximate unless called by the owner while no thread steals
+	size_t size() const {
+		auto b = bottom_.load(std::memory_order_relaxed);
+		auto t = top_.load(std::memory_order_relaxed);
+		return b > t ? static_cast<size_t>(b - t) : 0;
+	}
+
+	size_t capacity() const {
+		return array_.load(std::memory_order_relaxed)->capacity();
+	}
+
+	// owner only
+	void push_back(pointer p) {
+		auto b = bottom_.load(std::memory_order_relaxed);
+		auto t = top_.load(std::memory_order_acquire);
+		auto a = array_.load(std::memory_order_relaxed);
+		if (static_cast<int64_t>(a->capacity()) <= b - t)
+			a = grow(a, t, b);
+		a->put(b, p);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom_.store(b + 1, std::memory_order_relaxed);
+	}
+
+	// owner only
+	// Return nullptr if empty
+	pointer pop_back() {
+		auto b = bottom_.load(std::memory_order_relaxed) - 1;
+		auto a = array_.load(std::memory_order_relaxed);
+		bottom_.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top_.load(std::memory_order_relaxed);
+
+		pointer ret = nullptr;
+		if (t <= b) {
+			ret = a->get(b);
+			if (t != b)
+				return ret;
+			// the last object, race with thieves
+			if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				ret = nullptr;
+		}
+		bottom_.store(b + 1, std::memory_order_relaxed);
+		return ret;
+	}
+
+	// any thread
+	// Return nullptr if empty, or if another thread took the object first
+	pointer steal() {
+		auto t = top_.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto b = bottom_.load(std::memory_order_acquire);
+		if (b <= t)
+			return nullptr;
+
+		auto ret = array_.load(std::memory_order_acquire)->get(t);
+		if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return ret;
+	}
+
+	// same as steal, for the owner to take the oldest object
+	pointer pop_front() {
+		return steal();
+	}
+
+private:
+	// thieves
+	alignas(DLOU_CACHE_LINE) std::atomic<int64_t> top_{ 0 };
+	// owner
+	alignas(DLOU_CACHE_LINE) std::atomic<int64_t> bottom_{ 0 };
+	std::atomic<ring*> array_;
+};
+
 } // namespace dlou
@@ -21,6 +21,10 @@ public:
 	using key_compare = Compare;
 	using functors = std::tuple<Predicates...>;
 
+private:
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<key_compare>, K>;
+
 protected:
 	static constexpr map_type make_map(const key_type(&arr)[max_size]) {
 		std::pair<key_type, size_t> tmp[max_size];
@@ -41,43 +45,45 @@ public:
 
 	template<class... Args>
 	constexpr auto operator ()(const key_type& key, Args&&... args) {
-		using result_type = std::invoke_result_t<decltype(arr_), size_t, Args...>;
-		if constexpr (std::is_same_v<void, result_type>) {
-			auto pos = map_.find(key);
-			if (map_.end() == pos)
-				return false;
-			arr_(pos->second, std::forward<Args>(args)...);
-			return true;
-		}
-		else {
-			std::optional<result_type> ret;
-			auto pos = map_.find(key);
-			if (map_.end() != pos)
-				ret = std::move(arr_(pos->second, std::forward<Args>(args)...));
-			return ret;
-		}
+		return invoke(*this, key, std::forward<Args>(args)...);
 	}
 
 	template<class... Args>
 	constexpr auto operator ()(const key_type& key, Args&&... args) const {
-		using result_type = std::invoke_result_t<decltype(arr_), size_t, Args...>;
+		return invoke(*this, key, std::forward<Args>(args)...);
+	}
+
+	// transparent key_compare
+	template<class K, class... Args, class = transparent_t<K>>
+	constexpr auto operator ()(const K& key, Args&&... args) {
+		return invoke(*this, key, std::forward<Args>(args)...);
+	}
+
+	template<class K, class... Args, class = transparent_t<K>>
+	constexpr auto operator ()(const K& key, Args&&... args) const {
+		return invoke(*this, key, std::forward<Args>(args)...);
+	}
+
+private:
+	template<class Self, class K, class... Args>
+	static constexpr auto invoke(Self& self, const K& key, Args&&... args) {
+		using result_type = std::invoke_result_t<decltype((self.arr_)), size_t, Args...>;
 		if constexpr (std::is_same_v<void, result_type>) {
-			auto pos = map_.find(key);
-			if (map_.end() == pos)
+			auto pos = self.map_.find(key);
+			if (self.map_.end() == pos)
 				return false;
-			arr_(pos->second, std::forward<Args>(args)...);
+			self.arr_(pos->second, std::forward<Args>(args)...);
 			return true;
 		}
 		else {
 			std::optional<result_type> ret;
-			auto pos = map_.find(key);
-			if (map_.end() != pos)
-				ret = std::move(arr_(pos->second, std::forward<Args>(args)...));
+			auto pos = self.map_.find(key);
+			if (self.map_.end() != pos)
+				ret = std::move(self.arr_(pos->second, std::forward<Args>(args)...));
 			return ret;
 		}
 	}
 
-private:
 	map_type map_;
 	functor_array<Predicates...> arr_;
 };
@@ -1,15 +1,172 @@
 #pragma once
 
 #include "integer.hpp"
+#include "static.hpp"
 
 #include <cstddef>
+#include <cstdint>
 
 #include <type_traits>
 #include <functional>
+#include <stdexcept>
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#ifdef DLOU_SSE2
+#include <emmintrin.h>
+#endif
 
 
 namespace dlou {
 
+namespace _hash_table {
+	// keys per pass of find_batch
+	static constexpr size_t batch_size = 32;
+
+	// hash a pass of keys and prefetch their slots, then prefetch the elements, then search
+	// so the cache misses of a pass overlap
+	template<class Key, class Pointer, class Hash, class PrefetchSlot, class PrefetchData, class Find>
+	void find_batch(const Key* keys, size_t n, Pointer* out, const Hash& hash, PrefetchSlot prefetch_slot, PrefetchData prefetch_data, Find find) {
+		size_t idx[batch_size];
+
+		while (n) {
+			const size_t cnt = n < batch_size ? n : batch_size;
+			for (size_t i = 0; i < cnt; ++i) {
+				idx[i] = hash(keys[i]);
+				prefetch_slot(idx[i]);
+			}
+			for (size_t i = 0; i < cnt; ++i)
+				prefetch_data(idx[i]);
+			for (size_t i = 0; i < cnt; ++i)
+				out[i] = find(keys[i], idx[i]);
+
+			keys += cnt;
+			out += cnt;
+			n -= cnt;
+		}
+	}
+
+	// get(p) : the value of p found by find_batch, or the invalid value
+	template<class Pointer, class Key, class Value, class FindBatch, class Get>
+	void at_batch(const Key* keys, size_t n, Value* out, FindBatch find_batch, Get get) {
+		Pointer ret[batch_size];
+
+		while (n) {
+			const size_t cnt = n < batch_size ? n : batch_size;
+			find_batch(keys, cnt, ret);
+			for (size_t i = 0; i < cnt; ++i)
+				out[i] = get(ret[i]);
+
+			keys += cnt;
+			out += cnt;
+			n -= cnt;
+		}
+	}
+
+	// open addressing slot with optional truncated hash
+	template<class NodePos, class Tag>
+	struct slot {
+		NodePos pos;
+		Tag tag;
+	};
+
+	template<class NodePos>
+	struct slot<NodePos, void> {
+		NodePos pos;
+	};
+
+	// SwissTable control group
+	//  empty : 0b1000'0000
+	//  full  : 0b0xxx'xxxx (7 bits hash)
+	static constexpr size_t group_width = 16;
+	static constexpr uint8_t ctrl_empty = 0x80;
+
+	static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+	static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+	static constexpr uint64_t load(const uint8_t* p) {
+		uint64_t ret = 0;
+		for (uint8_t i = 0; i < 8; ++i)
+			ret |= uint64_t(p[i]) << (i * 8);
+		return ret;
+	}
+
+	// 0x80 of each byte -> bit of byte index
+	static constexpr uint32_t to_mask(uint64_t v) {
+		return static_cast<uint32_t>(((v >> 7) * 0x0102040810204080ULL) >> 56);
+	}
+
+	// bit i is set if ctrl[i] == h2
+	// may report false positive after a matched byte, always verify by key
+	static constexpr uint32_t match_swar(const uint8_t* ctrl, uint8_t h2) {
+		uint32_t ret = 0;
+		for (size_t i = 0; i < group_width; i += 8) {
+			uint64_t v = load(ctrl + i) ^ (lsbs * h2);
+			ret |= to_mask((v - lsbs) & ~v & msbs) << i;
+		}
+		return ret;
+	}
+
+	// bit i is set if ctrl[i] is empty
+	static constexpr uint32_t match_empty_swar(const uint8_t* ctrl) {
+		uint32_t ret = 0;
+		for (size_t i = 0; i < group_width; i += 8)
+			ret |= to_mask(load(ctrl + i) & msbs) << i;
+		return ret;
+	}
+
+	static constexpr uint32_t match(const uint8_t* ctrl, uint8_t h2) {
+#ifdef DLOU_SSE2
+		if DLOU_IS_CONSTEVAL {
+			return match_swar(ctrl, h2);
+		}
+		else {
+			auto grp = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+			auto cmp = _mm_cmpeq_epi8(grp, _mm_set1_epi8(static_cast<char>(h2)));
+			return static_cast<uint32_t>(_mm_movemask_epi8(cmp));
+		}
+#else
+		return match_swar(ctrl, h2);
+#endif
+	}
+
+	static constexpr uint32_t match_empty(const uint8_t* ctrl) {
+#ifdef DLOU_SSE2
+		if DLOU_IS_CONSTEVAL {
+			return match_empty_swar(ctrl);
+		}
+		else {
+			auto grp = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+			return static_cast<uint32_t>(_mm_movemask_epi8(grp));
+		}
+#else
+		return match_empty_swar(ctrl);
+#endif
+	}
+
+	static constexpr size_t mix(size_t h) {
+		if constexpr (sizeof(size_t) > 4) {
+			h ^= h >> 32;
+			return h * size_t(0x9E3779B97F4A7C15ULL);
+		}
+		else {
+			h ^= h >> 16;
+			return h * size_t(0x9E3779B9UL);
+		}
+	}
+
+	// position of group
+	static constexpr size_t h1(size_t h) {
+		return h;
+	}
+
+	// 7 bits hash in control byte
+	static constexpr uint8_t h2(size_t h) {
+		return static_cast<uint8_t>(h >> (sizeof(size_t) * 8 - 7));
+	}
+} // namespace _hash_table
+
 template<
 	size_t N,
 	class Key,
@@ -37,6 +194,9 @@ private:
 	using nodepos = uint_t<(base2::log_ceil(N + 1 /* invalid_pos */) + 7U) / 8U>;
 	static constexpr nodepos invalid_pos = ~nodepos(0);
 
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<hasher> && is_transparent_v<key_equal>, K>;
+
 	struct node {
 		nodepos next;
 		value_type value;
@@ -89,18 +249,67 @@ public:
 	}
 
 	constexpr pointer find(const key_type& k) const {
-		key_equal eq;
+		return _find(k, hasher{}(k));
+	}
 
-		auto pos = slot_[bucket(k)];
-		while (invalid_pos != pos) {
-			const node& n = data_[pos];
-			if (eq(get_key(n.value), k))
-				return &n.value;
-			pos = n.next;
-		}
-		return nullptr;
+	// h == hasher{}(k)
+	constexpr pointer find(const key_type& k, size_t h) const {
+		return _find(k, h);
 	}
 
+	// transparent hasher and key_equal
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (ret)
+			return get_val(*ret);
+		return invalid;
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k) const {
+		return _find(k, hasher{}(k));
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k, size_t h) const {
+		return _find(k, h);
+	}
+
+	// Return nullptr if not found
+	void find_batch(const key_type* keys, size_t n, pointer* out) const {
+		_hash_table::find_batch(keys, n, out, hasher{}
+			, [this](size_t h) { DLOU_PREFETCH(slot_ + h % Bucket); }
+			, [this](size_t h) {
+				auto pos = slot_[h % Bucket];
+				if (invalid_pos != pos)
+					DLOU_PREFETCH(data_ + pos);
+			}
+			, [this](const key_type& k, size_t h) { return _find(k, h); });
+	}
+
+	void at_batch(const key_type* keys, size_t n, mapped_type* out, const mapped_type& invalid = mapped_type{}) const {
+		_hash_table::at_batch<pointer>(keys, n, out
+			, [this](const key_type* k, size_t cnt, pointer* ret) { find_batch(k, cnt, ret); }
+			, [&](pointer p) -> const mapped_type& { return p ? get_val(*p) : invalid; });
+	}
+
+#ifdef __cpp_lib_span
+	// Return the number of keys processed, min(keys.size(), out.size())
+	size_t find_batch(std::span<const key_type> keys, std::span<pointer> out) const {
+		const size_t n = keys.size() < out.size() ? keys.size() : out.size();
+		find_batch(keys.data(), n, out.data());
+		return n;
+	}
+
+	// Return the number of keys processed, min(keys.size(), out.size())
+	size_t at_batch(std::span<const key_type> keys, std::span<mapped_type> out, const mapped_type& invalid = mapped_type{}) const {
+		const size_t n = keys.size() < out.size() ? keys.size() : out.size();
+		at_batch(keys.data(), n, out.data(), invalid);
+		return n;
+	}
+#endif//__cpp_lib_span
+
 	constexpr size_t bucket_size(size_t n) const {
 		nodepos pos = slot_[n];
 		size_t cnt = 0;
@@ -128,6 +337,20 @@ public:
 	}
 
 private:
+	template<class K>
+	constexpr pointer _find(const K& k, size_t h) const {
+		key_equal eq;
+
+		auto pos = slot_[h % Bucket];
+		while (invalid_pos != pos) {
+			const node& n = data_[pos];
+			if (eq(get_key(n.value), k))
+				return &n.value;
+			pos = n.next;
+		}
+		return nullptr;
+	}
+
 	static constexpr const key_type& get_key(const value_type& v) {
 		if constexpr (std::is_same<void, Val>::value)
 			return v;
@@ -198,8 +421,9 @@ template<
 	class Val = void,
 	class Hash = std::hash<Key>,
 	class Pred = std::equal_to<Key>,
-	size_t Slots = N * 2>
-DLOU_REQUIRES(N > 0 && Slots >= N)
+	size_t Slots = N * 2,
+	class Tag = void>
+DLOU_REQUIRES(N > 0 && Slots >= N && (std::is_void_v<Tag> || std::is_unsigned_v<Tag>))
 class hash_table
 {
 public:
@@ -211,11 +435,16 @@ public:
 	using value_type = typename std::conditional<std::is_same<void, Val>::value, key_type, std::pair<key_type, mapped_type>>::type;
 	using reference = const value_type&;
 	using pointer = const value_type*;
+	using tag_type = Tag;
 
 private:
 	using nodepos = uint_t<(base2::log_ceil(N + 1 /* invalid_pos */) + 7U) / 8U>;
+	using slot_type = _hash_table::slot<nodepos, Tag>;
 	static constexpr nodepos invalid_pos = ~nodepos(0);
 
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<hasher> && is_transparent_v<key_equal>, K>;
+
 public:
 	constexpr hash_table(const hash_table&) = default;
 	constexpr hash_table& operator =(const hash_table&) = default;
@@ -229,13 +458,13 @@ public:
 		return *this;
 	}
 
-	template<class OldHash, class OldPred, size_t OldSlots>
-	constexpr hash_table(const hash_table<N, Key, Val, OldHash, OldPred, OldSlots>& x) {
+	template<class OldHash, class OldPred, size_t OldSlots, class OldTag>
+	constexpr hash_table(const hash_table<N, Key, Val, OldHash, OldPred, OldSlots, OldTag>& x) {
 		clone(x.data());
 	}
 
-	template<class OldHash, class OldPred, size_t OldSlots>
-	constexpr hash_table& operator =(const hash_table<N, Key, Val, OldHash, OldPred, OldSlots>& x) {
+	template<class OldHash, class OldPred, size_t OldSlots, class OldTag>
+	constexpr hash_table& operator =(const hash_table<N, Key, Val, OldHash, OldPred, OldSlots, OldTag>& x) {
 		clone(x.data());
 		return *this;
 	}
@@ -255,29 +484,73 @@ public:
 
 	constexpr const mapped_type& at(const key_type& k, const mapped_type& invalid = mapped_type{}) const {
 		auto ret = find(k);
-		if (ret)
+		if (end() != ret)
 			return get_val(*ret);
 		return invalid;
 	}
 
 	constexpr pointer find(const key_type& k) const {
-		hasher hash;
-		key_equal eq;
+		return _find(k, hasher{}(k));
+	}
 
-		auto idx = hash(k);
-		for (size_t i = 1; i <= slot_count; ++i) {
-			idx %= slot_count;
-			auto pos = slot_[idx];
-			if (invalid_pos == pos)
-				break;
-			auto ptr = arr_ + pos;
-			if (eq(k, get_key(*ptr)))
-				return ptr;
-			idx += i;
-		}
-		return end();
+	// h == hasher{}(k)
+	constexpr pointer find(const key_type& k, size_t h) const {
+		return _find(k, h);
 	}
 
+	// transparent hasher and key_equal
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (end() != ret)
+			return get_val(*ret);
+		return invalid;
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k) const {
+		return _find(k, hasher{}(k));
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k, size_t h) const {
+		return _find(k, h);
+	}
+
+	// Return end() if not found
+	void find_batch(const key_type* keys, size_t n, pointer* out) const {
+		_hash_table::find_batch(keys, n, out, hasher{}
+			, [this](size_t h) { DLOU_PREFETCH(slot_ + h % slot_count); }
+			, [this](size_t h) {
+				auto& s = slot_[h % slot_count];
+				if (invalid_pos != s.pos && match_tag(s, h))
+					DLOU_PREFETCH(arr_ + s.pos);
+			}
+			, [this](const key_type& k, size_t h) { return _find(k, h); });
+	}
+
+	void at_batch(const key_type* keys, size_t n, mapped_type* out, const mapped_type& invalid = mapped_type{}) const {
+		_hash_table::at_batch<pointer>(keys, n, out
+			, [this](const key_type* k, size_t cnt, pointer* ret) { find_batch(k, cnt, ret); }
+			, [&](pointer p) -> const mapped_type& { return (end() != p) ? get_val(*p) : invalid; });
+	}
+
+#ifdef __cpp_lib_span
+	// Return the number of keys processed, min(keys.size(), out.size())
+	size_t find_batch(std::span<const key_type> keys, std::span<pointer> out) const {
+		const size_t n = keys.size() < out.size() ? keys.size() : out.size();
+		find_batch(keys.data(), n, out.data());
+		return n;
+	}
+
+	// Return the number of keys processed, min(keys.size(), out.size())
+	size_t at_batch(std::span<const key_type> keys, std::span<mapped_type> out, const mapped_type& invalid = mapped_type{}) const {
+		const size_t n = keys.size() < out.size() ? keys.size() : out.size();
+		at_batch(keys.data(), n, out.data(), invalid);
+		return n;
+	}
+#endif//__cpp_lib_span
+
 	constexpr size_t collision_count(const key_type& k) const {
 		hasher hash;
 		key_equal eq;
@@ -285,7 +558,7 @@ public:
 		auto idx = hash(k);
 		for (size_t i = 1; i <= slot_count; ++i) {
 			idx %= slot_count;
-			auto pos = slot_[idx];
+			auto pos = slot_[idx].pos;
 			if (invalid_pos == pos || eq(k, get_key(arr_[pos])))
 				return i - 1;
 			idx += i;
@@ -302,7 +575,7 @@ public:
 			auto idx = hash(get_key(arr_[pos]));
 			for (size_t i = 1; i <= slot_count; ++i) {
 				idx %= slot_count;
-				if (pos == slot_[idx]) {
+				if (pos == slot_[idx].pos) {
 					--i;
 					if (ret < i)
 						ret = i;
@@ -315,6 +588,26 @@ public:
 	}
 
 private:
+	template<class K>
+	constexpr pointer _find(const K& k, size_t h) const {
+		key_equal eq;
+
+		size_t idx = h;
+		for (size_t i = 1; i <= slot_count; ++i) {
+			idx %= slot_count;
+			auto& s = slot_[idx];
+			if (invalid_pos == s.pos)
+				break;
+			if (match_tag(s, h)) {
+				auto ptr = arr_ + s.pos;
+				if (eq(k, get_key(*ptr)))
+					return ptr;
+			}
+			idx += i;
+		}
+		return end();
+	}
+
 	static constexpr const key_type& get_key(const value_type& v) {
 		if constexpr (std::is_same<void, Val>::value)
 			return v;
@@ -328,22 +621,37 @@ private:
 			return v.second;
 	}
 
+	// truncated hash above the bits of slot index
+	static constexpr void set_tag(slot_type& s, size_t h) {
+		if constexpr (!std::is_void<Tag>::value)
+			s.tag = static_cast<Tag>(h >> base2::log(slot_count));
+	}
+
+	static constexpr bool match_tag(const slot_type& s, size_t h) {
+		if constexpr (std::is_void<Tag>::value)
+			return true;
+		else
+			return s.tag == static_cast<Tag>(h >> base2::log(slot_count));
+	}
+
 	constexpr void clone(const value_type* p) {
 		hasher hash;
 		key_equal eq;
 
 		for (auto& v : slot_)
-			v = invalid_pos;
+			v = slot_type{ invalid_pos };
 
 		for (auto& v : arr_) {
 			v = *p++;
 
-			auto idx = hash(get_key(v));
+			const size_t h = hash(get_key(v));
+			size_t idx = h;
 			for (size_t i = 1; i <= slot_count; ++i) {
 				idx %= slot_count;
-				auto& pos = slot_[idx];
-				if (invalid_pos == pos) {
-					pos = static_cast<nodepos>(&v - arr_);
+				auto& s = slot_[idx];
+				if (invalid_pos == s.pos) {
+					s.pos = static_cast<nodepos>(&v - arr_);
+					set_tag(s, h);
 					break;
 				}
 				idx += i;
@@ -352,7 +660,7 @@ private:
 	}
 
 private:
-	nodepos slot_[slot_count];
+	slot_type slot_[slot_count];
 	value_type arr_[N];
 };
 
@@ -385,8 +693,9 @@ template<size_t N,
 	class Hash = std::hash<Key>,
 	class Hash2 = std::hash<Key>,
 	class Pred = std::equal_to<Key>,
-	size_t Slots = N * 2>
-DLOU_REQUIRES(N > 0 && Slots >= N)
+	size_t Slots = N * 2,
+	class Tag = void>
+DLOU_REQUIRES(N > 0 && Slots >= N && (std::is_void_v<Tag> || std::is_unsigned_v<Tag>))
 class double_hash_table
 {
 public:
@@ -399,11 +708,16 @@ public:
 	using value_type = typename std::conditional<std::is_same<void, Val>::value, key_type, std::pair<key_type, mapped_type>>::type;
 	using reference = const value_type&;
 	using pointer = const value_type*;
+	using tag_type = Tag;
 
 private:
 	using nodepos = uint_t<(base2::log_ceil(N + 1 /* invalid_pos */) + 7U) / 8U>;
+	using slot_type = _hash_table::slot<nodepos, Tag>;
 	static constexpr nodepos invalid_pos = ~nodepos(0);
 
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<hasher> && is_transparent_v<hasher2> && is_transparent_v<key_equal>, K>;
+
 public:
 	constexpr double_hash_table(const double_hash_table&) = default;
 	constexpr double_hash_table& operator =(const double_hash_table&) = default;
@@ -417,13 +731,13 @@ public:
 		return *this;
 	}
 
-	template<class OldHash, class OldHash2, class OldPred, size_t OldSlots>
-	constexpr double_hash_table(const double_hash_table<N, Key, Val, OldHash, OldHash2, OldPred, OldSlots>& x) {
+	template<class OldHash, class OldHash2, class OldPred, size_t OldSlots, class OldTag>
+	constexpr double_hash_table(const double_hash_table<N, Key, Val, OldHash, OldHash2, OldPred, OldSlots, OldTag>& x) {
 		clone(x.data());
 	}
 
-	template<class OldHash, class OldHash2, class OldPred, size_t OldSlots>
-	constexpr double_hash_table& operator =(const double_hash_table<N, Key, Val, OldHash, OldHash2, OldPred, OldSlots>& x) {
+	template<class OldHash, class OldHash2, class OldPred, size_t OldSlots, class OldTag>
+	constexpr double_hash_table& operator =(const double_hash_table<N, Key, Val, OldHash, OldHash2, OldPred, OldSlots, OldTag>& x) {
 		clone(x.data());
 		return *this;
 	}
@@ -443,43 +757,90 @@ public:
 
 	constexpr const mapped_type& at(const key_type& k, const mapped_type& invalid = mapped_type{}) const {
 		auto ret = find(k);
-		if (ret)
+		if (end() != ret)
 			return get_val(*ret);
 		return invalid;
 	}
 
 	constexpr pointer find(const key_type& k) const {
-		hasher hash;
-		hasher2 hash2;
-		key_equal eq;
+		return _find(k, hasher{}(k));
+	}
 
-		size_t idx = hash(k);
-		auto pos = slot_[idx % slot_count];
-		if (invalid_pos == pos)
-			return end();
-		auto ptr = arr_ + pos;
-		if (eq(k, get_key(*ptr)))
-			return ptr;
+	// h == hasher{}(k), hasher2 is still called on a collision
+	constexpr pointer find(const key_type& k, size_t h) const {
+		return _find(k, h);
+	}
 
-		const size_t offset = (hash2(k) << 1) | size_t(1);
-		for (size_t i = 1; i < slot_count; ++i) {
-			auto pos = slot_[(idx += offset) % slot_count];
-			if (invalid_pos == pos)
-				break;
-			auto ptr = arr_ + pos;
-			if (eq(k, get_key(*ptr)))
-				return ptr;
-		}
-		return end();
+	// h == hasher{}(k), h2 == hasher2{}(k)
+	constexpr pointer find(const key_type& k, size_t h, size_t h2) const {
+		return _find(k, h, [h2]() { return h2; });
+	}
+
+	// transparent hasher and key_equal
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (end() != ret)
+			return get_val(*ret);
+		return invalid;
 	}
 
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k) const {
+		return _find(k, hasher{}(k));
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k, size_t h) const {
+		return _find(k, h);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k, size_t h, size_t h2) const {
+		return _find(k, h, [h2]() { return h2; });
+	}
+
+	// Return end() if not found
+	void find_batch(const key_type* keys, size_t n, pointer* out) const {
+		_hash_table::find_batch(keys, n, out, hasher{}
+			, [this](size_t h) { DLOU_PREFETCH(slot_ + h % slot_count); }
+			, [this](size_t h) {
+				auto& s = slot_[h % slot_count];
+				if (invalid_pos != s.pos && match_tag(s, h))
+					DLOU_PREFETCH(arr_ + s.pos);
+			}
+			, [this](const key_type& k, size_t h) { return _find(k, h); });
+	}
+
+	void at_batch(const key_type* keys, size_t n, mapped_type* out, const mapped_type& invalid = mapped_type{}) const {
+		_hash_table::at_batch<pointer>(keys, n, out
+			, [this](const key_type* k, size_t cnt, pointer* ret) { find_batch(k, cnt, ret); }
+			, [&](pointer p) -> const mapped_type& { return (end() != p) ? get_val(*p) : invalid; });
+	}
+
+#ifdef __cpp_lib_span
+	// Return the number of keys processed, min(keys.size(), out.size())
+	size_t find_batch(std::span<const key_type> keys, std::span<pointer> out) const {
+		const size_t n = keys.size() < out.size() ? keys.size() : out.size();
+		find_batch(keys.data(), n, out.data());
+		return n;
+	}
+
+	// Return the number of keys processed, min(keys.size(), out.size())
+	size_t at_batch(std::span<const key_type> keys, std::span<mapped_type> out, const mapped_type& invalid = mapped_type{}) const {
+		const size_t n = keys.size() < out.size() ? keys.size() : out.size();
+		at_batch(keys.data(), n, out.data(), invalid);
+		return n;
+	}
+#endif//__cpp_lib_span
+
 	constexpr size_t collision_count(const key_type& k) const {
 		hasher hash;
 		hasher2 hash2;
 		key_equal eq;
 
 		size_t idx = hash(k);
-		auto pos = slot_[idx % slot_count];
+		auto pos = slot_[idx % slot_count].pos;
 		if (invalid_pos == pos)
 			return 0;
 		auto ptr = arr_ + pos;
@@ -488,7 +849,7 @@ public:
 
 		const size_t offset = (hash2(k) << 1) | size_t(1);
 		for (size_t i = 1; i < slot_count; ++i) {
-			auto pos = slot_[(idx += offset) % slot_count];
+			auto pos = slot_[(idx += offset) % slot_count].pos;
 			if (invalid_pos == pos || eq(k, get_key(arr_[pos])))
 				return i;
 		}
@@ -504,12 +865,12 @@ public:
 		for (nodepos pos = 0; pos < std::extent_v<decltype(arr_)>; ++pos) {
 			auto& k = get_key(arr_[pos]);
 			size_t idx = hash(k);
-			if (pos == slot_[idx % slot_count])
+			if (pos == slot_[idx % slot_count].pos)
 				continue;
 
 			const size_t offset = (hash2(k) << 1) | size_t(1);
 			for (size_t i = 1; i < slot_count; ++i) {
-				if (pos == slot_[(idx += offset) % slot_count]) {
+				if (pos == slot_[(idx += offset) % slot_count].pos) {
 					if (ret < i)
 						ret = i;
 					break;
@@ -520,6 +881,40 @@ public:
 	}
 
 private:
+	template<class K>
+	constexpr pointer _find(const K& k, size_t h) const {
+		return _find(k, h, [&k]() { return hasher2{}(k); });
+	}
+
+	// hash2() is called on the first collision only
+	template<class K, class Hash2Of>
+	constexpr pointer _find(const K& k, size_t h, Hash2Of hash2) const {
+		key_equal eq;
+
+		size_t idx = h;
+		auto& s = slot_[idx % slot_count];
+		if (invalid_pos == s.pos)
+			return end();
+		if (match_tag(s, h)) {
+			auto ptr = arr_ + s.pos;
+			if (eq(k, get_key(*ptr)))
+				return ptr;
+		}
+
+		const size_t offset = (hash2() << 1) | size_t(1);
+		for (size_t i = 1; i < slot_count; ++i) {
+			auto& s = slot_[(idx += offset) % slot_count];
+			if (invalid_pos == s.pos)
+				break;
+			if (match_tag(s, h)) {
+				auto ptr = arr_ + s.pos;
+				if (eq(k, get_key(*ptr)))
+					return ptr;
+			}
+		}
+		return end();
+	}
+
 	static constexpr const key_type& get_key(const value_type& v) {
 		if constexpr (std::is_same<void, Val>::value)
 			return v;
@@ -533,30 +928,46 @@ private:
 			return v.second;
 	}
 
+	// truncated hash above the bits of slot index
+	static constexpr void set_tag(slot_type& s, size_t h) {
+		if constexpr (!std::is_void<Tag>::value)
+			s.tag = static_cast<Tag>(h >> base2::log(slot_count));
+	}
+
+	static constexpr bool match_tag(const slot_type& s, size_t h) {
+		if constexpr (std::is_void<Tag>::value)
+			return true;
+		else
+			return s.tag == static_cast<Tag>(h >> base2::log(slot_count));
+	}
+
 	constexpr void clone(const value_type* p) {
 		hasher hash;
 		hasher2 hash2;
 		key_equal eq;
 
 		for (auto& v : slot_)
-			v = invalid_pos;
+			v = slot_type{ invalid_pos };
 
 		for (auto& v : arr_) {
 			v = *p++;
 
 			auto& key = get_key(v);
-			size_t idx = hash(key);
-			auto& pos = slot_[idx % slot_count];
-			if (invalid_pos == pos) {
-				pos = static_cast<nodepos>(&v - arr_);
+			const size_t h = hash(key);
+			size_t idx = h;
+			auto& s = slot_[idx % slot_count];
+			if (invalid_pos == s.pos) {
+				s.pos = static_cast<nodepos>(&v - arr_);
+				set_tag(s, h);
 				continue;
 			}
 
 			const size_t offset = (hash2(key) << 1) | size_t(1);
 			for (size_t i = 1; i < slot_count; ++i) {
-				auto& pos = slot_[(idx += offset) % slot_count];
-				if (invalid_pos == pos) {
-					pos = static_cast<nodepos>(&v - arr_);
+				auto& s = slot_[(idx += offset) % slot_count];
+				if (invalid_pos == s.pos) {
+					s.pos = static_cast<nodepos>(&v - arr_);
+					set_tag(s, h);
 					break;
 				}
 			}
@@ -564,7 +975,7 @@ private:
 	}
 
 private:
-	nodepos slot_[slot_count];
+	slot_type slot_[slot_count];
 	value_type arr_[N];
 };
 
@@ -591,4 +1002,472 @@ constexpr auto make_dhash_set(const Key(&arr)[N])
 	return double_hash_table<N, Key, void, Hash, Hash2, Pred>(arr);
 }
 
+
+// Group Probing (SwissTable)
+template<
+	size_t N,
+	class Key,
+	class Val = void,
+	class Hash = std::hash<Key>,
+	class Pred = std::equal_to<Key>,
+	size_t Slots = N * 2>
+DLOU_REQUIRES(N > 0 && Slots >= N)
+class group_hash_table
+{
+public:
+	static const size_t group_width = _hash_table::group_width;
+	static const size_t group_count = base2::ceil((Slots + group_width - 1) / group_width);
+	static const size_t slot_count = group_count * group_width;
+	using key_type = Key;
+	using mapped_type = typename std::conditional<std::is_same<void, Val>::value, Key, Val>::type;
+	using hasher = Hash;
+	using key_equal = Pred;
+	using value_type = typename std::conditional<std::is_same<void, Val>::value, key_type, std::pair<key_type, mapped_type>>::type;
+	using reference = const value_type&;
+	using pointer = const value_type*;
+
+private:
+	using nodepos = uint_t<(base2::log_ceil(N + 1 /* invalid_pos */) + 7U) / 8U>;
+	static constexpr nodepos invalid_pos = ~nodepos(0);
+
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<hasher> && is_transparent_v<key_equal>, K>;
+
+public:
+	constexpr group_hash_table(const group_hash_table&) = default;
+	constexpr group_hash_table& operator =(const group_hash_table&) = default;
+
+	constexpr group_hash_table(const value_type(&x)[N]) {
+		clone(x);
+	}
+
+	constexpr group_hash_table& operator =(const value_type(&x)[N]) {
+		clone(x);
+		return *this;
+	}
+
+	template<class OldHash, class OldPred, size_t OldSlots>
+	constexpr group_hash_table(const group_hash_table<N, Key, Val, OldHash, OldPred, OldSlots>& x) {
+		clone(x.data());
+	}
+
+	template<class OldHash, class OldPred, size_t OldSlots>
+	constexpr group_hash_table& operator =(const group_hash_table<N, Key, Val, OldHash, OldPred, OldSlots>& x) {
+		clone(x.data());
+		return *this;
+	}
+
+	constexpr size_t size() const { return N; }
+	constexpr pointer data() const { return arr_; }
+	constexpr pointer begin() const { return arr_; }
+	constexpr pointer end() const { return arr_ + N; }
+
+	constexpr const mapped_type& operator [](const key_type& k) const {
+#ifdef DLOU_CHECK_ARGS
+		return at(k);
+#else
+		return get_val(*find(k));
+#endif
+	}
+
+	constexpr const mapped_type& at(const key_type& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (end() != ret)
+			return get_val(*ret);
+		return invalid;
+	}
+
+	constexpr pointer find(const key_type& k) const {
+		return _find(k);
+	}
+
+	// transparent hasher and key_equal
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (end() != ret)
+			return get_val(*ret);
+		return invalid;
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k) const {
+		return _find(k);
+	}
+
+	// count of probed groups before the target group
+	constexpr size_t collision_count(const key_type& k) const {
+		key_equal eq;
+
+		const size_t h = _hash_table::mix(hasher{}(k));
+		const uint8_t tag = _hash_table::h2(h);
+		size_t idx = _hash_table::h1(h);
+		for (size_t i = 1; i <= group_count; ++i) {
+			idx %= group_count;
+			auto ctrl = ctrl_ + idx * group_width;
+			for (auto bits = _hash_table::match(ctrl, tag); bits; bits &= bits - 1) {
+				if (eq(k, get_key(arr_[slot_[idx * group_width + bit::bsf(bits)]])))
+					return i - 1;
+			}
+			if (_hash_table::match_empty(ctrl))
+				return i - 1;
+			idx += i;
+		}
+		return group_count;
+	}
+
+	constexpr size_t max_collision_count() const {
+		hasher hash;
+		size_t ret = 0;
+
+		for (nodepos pos = 0; pos < std::extent_v<decltype(arr_)>; ++pos) {
+			const size_t h = _hash_table::mix(hash(get_key(arr_[pos])));
+			size_t idx = _hash_table::h1(h);
+			for (size_t i = 1; i <= group_count; ++i) {
+				idx %= group_count;
+				if (contains(idx, pos)) {
+					--i;
+					if (ret < i)
+						ret = i;
+					break;
+				}
+				idx += i;
+			}
+		}
+		return ret;
+	}
+
+private:
+	template<class K>
+	constexpr pointer _find(const K& k) const {
+		key_equal eq;
+
+		const size_t h = _hash_table::mix(hasher{}(k));
+		const uint8_t tag = _hash_table::h2(h);
+		size_t idx = _hash_table::h1(h);
+		for (size_t i = 1; i <= group_count; ++i) {
+			idx %= group_count;
+			auto ctrl = ctrl_ + idx * group_width;
+			for (auto bits = _hash_table::match(ctrl, tag); bits; bits &= bits - 1) {
+				auto ptr = arr_ + slot_[idx * group_width + bit::bsf(bits)];
+				if (eq(k, get_key(*ptr)))
+					return ptr;
+			}
+			if (_hash_table::match_empty(ctrl))
+				break;
+			idx += i;
+		}
+		return end();
+	}
+
+	static constexpr const key_type& get_key(const value_type& v) {
+		if constexpr (std::is_same<void, Val>::value)
+			return v;
+		else
+			return v.first;
+	}
+	static constexpr const mapped_type& get_val(const value_type& v) {
+		if constexpr (std::is_same<void, Val>::value)
+			return v;
+		else
+			return v.second;
+	}
+
+	constexpr bool contains(size_t grp, nodepos pos) const {
+		auto beg = slot_ + grp * group_width;
+		for (auto p = beg; p != beg + group_width; ++p) {
+			if (pos == *p)
+				return true;
+		}
+		return false;
+	}
+
+	constexpr void clone(const value_type* p) {
+		hasher hash;
+
+		for (auto& v : ctrl_)
+			v = _hash_table::ctrl_empty;
+		for (auto& v : slot_)
+			v = invalid_pos;
+
+		for (auto& v : arr_) {
+			v = *p++;
+
+			const size_t h = _hash_table::mix(hash(get_key(v)));
+			size_t idx = _hash_table::h1(h);
+			for (size_t i = 1; i <= group_count; ++i) {
+				idx %= group_count;
+				auto ctrl = ctrl_ + idx * group_width;
+				if (auto bits = _hash_table::match_empty(ctrl)) {
+					auto off = bit::bsf(bits);
+					ctrl[off] = _hash_table::h2(h);
+					slot_[idx * group_width + off] = static_cast<nodepos>(&v - arr_);
+					break;
+				}
+				idx += i;
+			}
+		}
+	}
+
+private:
+	alignas(group_width) uint8_t ctrl_[slot_count];
+	nodepos slot_[slot_count];
+	value_type arr_[N];
+};
+
+template<
+	class Key,
+	class Val,
+	class Hash = std::hash<Key>,
+	class Pred = std::equal_to<Key>,
+	size_t N>
+constexpr auto make_ghash_map(const std::pair<Key, Val>(&arr)[N])
+{
+	return group_hash_table<N, Key, Val, Hash, Pred>(arr);
+}
+
+template<
+	class Key,
+	class Hash = std::hash<Key>,
+	class Pred = std::equal_to<Key>,
+	size_t N>
+constexpr auto make_ghash_set(const Key(&arr)[N])
+{
+	return group_hash_table<N, Key, void, Hash, Pred>(arr);
+}
+
+
+// Minimal Perfect Hashing (PtHash)
+template<
+	size_t N,
+	class Key,
+	class Val = void,
+	class Hash = std::hash<Key>,
+	class Pred = std::equal_to<Key>,
+	size_t Buckets = N / 2 + 1>
+DLOU_REQUIRES(N > 0 && Buckets > 0)
+class perfect_hash_table
+{
+public:
+	using key_type = Key;
+	using mapped_type = typename std::conditional<std::is_same<void, Val>::value, Key, Val>::type;
+	using hasher = Hash;
+	using key_equal = Pred;
+	using value_type = typename std::conditional<std::is_same<void, Val>::value, key_type, std::pair<key_type, mapped_type>>::type;
+	using reference = const value_type&;
+	using pointer = const value_type*;
+
+private:
+	using nodepos = uint_t<(base2::log_ceil(N + 1) + 7U) / 8U>;
+	using pilot_type = uint16_t;
+	static constexpr size_t max_pilot = pilot_type(~pilot_type(0));
+	static constexpr size_t max_seed = 64;
+
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<hasher> && is_transparent_v<key_equal>, K>;
+
+public:
+	constexpr perfect_hash_table(const perfect_hash_table&) = default;
+	constexpr perfect_hash_table& operator =(const perfect_hash_table&) = default;
+
+	constexpr perfect_hash_table(const value_type(&x)[N]) {
+		clone(x);
+	}
+
+	constexpr perfect_hash_table& operator =(const value_type(&x)[N]) {
+		clone(x);
+		return *this;
+	}
+
+	template<class OldHash, class OldPred, size_t OldBuckets>
+	constexpr perfect_hash_table(const perfect_hash_table<N, Key, Val, OldHash, OldPred, OldBuckets>& x) {
+		clone(x.data());
+	}
+
+	template<class OldHash, class OldPred, size_t OldBuckets>
+	constexpr perfect_hash_table& operator =(const perfect_hash_table<N, Key, Val, OldHash, OldPred, OldBuckets>& x) {
+		clone(x.data());
+		return *this;
+	}
+
+	constexpr size_t size() const { return N; }
+	constexpr size_t bucket_count() const { return Buckets; }
+	constexpr pointer data() const { return arr_; }
+	constexpr pointer begin() const { return arr_; }
+	constexpr pointer end() const { return arr_ + N; }
+
+	constexpr const mapped_type& operator [](const key_type& k) const {
+#ifdef DLOU_CHECK_ARGS
+		return at(k);
+#else
+		return get_val(*find(k));
+#endif
+	}
+
+	constexpr const mapped_type& at(const key_type& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (end() != ret)
+			return get_val(*ret);
+		return invalid;
+	}
+
+	constexpr pointer find(const key_type& k) const {
+		return _find(k);
+	}
+
+	// transparent hasher and key_equal
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		auto ret = find(k);
+		if (end() != ret)
+			return get_val(*ret);
+		return invalid;
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k) const {
+		return _find(k);
+	}
+
+private:
+	template<class K>
+	constexpr pointer _find(const K& k) const {
+		const size_t h = hash(k);
+		auto ptr = arr_ + position(h, pilot_[bucket(h)]);
+		if (key_equal{}(k, get_key(*ptr)))
+			return ptr;
+		return end();
+	}
+
+	static constexpr const key_type& get_key(const value_type& v) {
+		if constexpr (std::is_same<void, Val>::value)
+			return v;
+		else
+			return v.first;
+	}
+	static constexpr const mapped_type& get_val(const value_type& v) {
+		if constexpr (std::is_same<void, Val>::value)
+			return v;
+		else
+			return v.second;
+	}
+
+	template<class K>
+	constexpr size_t hash(const K& k) const {
+		return _hash_table::mix(hasher{}(k) ^ seed_);
+	}
+
+	static constexpr size_t bucket(size_t h) {
+		return (h >> (sizeof(size_t) * 4)) % Buckets;
+	}
+
+	// the high bits of the product depend on every bit of h and pilot
+	static constexpr size_t position(size_t h, pilot_type pilot) {
+		return (_hash_table::mix(h ^ pilot) >> (sizeof(size_t) * 4)) % N;
+	}
+
+	// throw on duplicate keys or if no seed up to max_seed works, a compile error in constant evaluation
+	constexpr void clone(const value_type* p) {
+		size_t hv[N];         // hash of p[i]
+		nodepos order[N];     // p index grouped by bucket
+		size_t last[Buckets]; // end of bucket in order
+		bool used[N];
+
+		for (size_t i = 1; i < N; ++i) {
+			for (size_t j = 0; j < i; ++j) {
+				if (key_equal{}(get_key(p[i]), get_key(p[j])))
+					throw std::invalid_argument("perfect_hash_table: duplicate key");
+			}
+		}
+
+		for (seed_ = 0; !build(p, hv, order, last, used); ) {
+			if (++seed_ == max_seed)
+				throw std::runtime_error("perfect_hash_table: no perfect hash found");
+		}
+
+		for (size_t i = 0; i < N; ++i)
+			arr_[position(hv[i], pilot_[bucket(hv[i])])] = p[i];
+	}
+
+	constexpr bool build(const value_type* p, size_t* hv, nodepos* order, size_t* last, bool* used) {
+		for (size_t b = 0; b < Buckets; ++b)
+			last[b] = 0;
+		for (size_t i = 0; i < N; ++i) {
+			used[i] = false;
+			hv[i] = hash(get_key(p[i]));
+			++last[bucket(hv[i])];
+		}
+
+		size_t max_count = 0;
+		for (size_t b = 0, sum = 0; b < Buckets; ++b) {
+			if (max_count < last[b])
+				max_count = last[b];
+			sum += last[b];
+			last[b] = sum - last[b];
+		}
+		for (size_t i = 0; i < N; ++i)
+			order[last[bucket(hv[i])]++] = static_cast<nodepos>(i);
+
+		// largest bucket first
+		for (size_t cnt = max_count; cnt; --cnt) {
+			for (size_t b = 0; b < Buckets; ++b) {
+				const size_t first = b ? last[b - 1] : 0;
+				if (cnt != last[b] - first)
+					continue;
+
+				size_t pilot = 0;
+				for (; pilot <= max_pilot; ++pilot) {
+					size_t j = first;
+					for (; j < last[b]; ++j) {
+						auto& u = used[position(hv[order[j]], static_cast<pilot_type>(pilot))];
+						if (u)
+							break;
+						u = true;
+					}
+					if (j == last[b])
+						break;
+
+					while (j-- > first)
+						used[position(hv[order[j]], static_cast<pilot_type>(pilot))] = false;
+				}
+				if (pilot > max_pilot)
+					return false;
+				pilot_[b] = static_cast<pilot_type>(pilot);
+			}
+		}
+
+		for (size_t b = 0; b < Buckets; ++b) {
+			if (last[b] == (b ? last[b - 1] : 0))
+				pilot_[b] = 0;
+		}
+		return true;
+	}
+
+private:
+	size_t seed_;
+	pilot_type pilot_[Buckets];
+	value_type arr_[N];
+};
+
+template<
+	class Key,
+	class Val,
+	class Hash = std::hash<Key>,
+	class Pred = std::equal_to<Key>,
+	size_t N>
+constexpr auto make_phash_map(const std::pair<Key, Val>(&arr)[N])
+{
+	return perfect_hash_table<N, Key, Val, Hash, Pred>(arr);
+}
+
+template<
+	class Key,
+	class Hash = std::hash<Key>,
+	class Pred = std::equal_to<Key>,
+	size_t N>
+constexpr auto make_phash_set(const Key(&arr)[N])
+{
+	return perfect_hash_table<N, Key, void, Hash, Pred>(arr);
+}
+
 } // namespace dlou
@@ -9,7 +9,10 @@
 #include <utility>
 #include <array>
 
-#ifdef __cpp_lib_int_pow2
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_int_pow2) || defined(__cpp_lib_bitops)
 #include <bit>
 #endif
 
@@ -96,11 +99,35 @@ constexpr uint8_t bsr(T v)
 #endif//__cpp_lib_int_pow2
 }
 
+
+// asm : popcnt
+// gcc : __builtin_popcount
+// win : __popcnt(64)
+// std : popcount
+template<typename T>
+DLOU_REQUIRES(std::is_integral<T>::value)
+constexpr uint8_t popcnt(T v)
+{
+	using uint = typename std::make_unsigned<T>::type;
+#ifdef __cpp_lib_bitops
+	return (uint8_t)std::popcount(static_cast<uint>(v));
+#elif defined(__GNUC__) || defined(__clang__)
+	return (uint8_t)__builtin_popcountll(static_cast<uint>(v));
+#else//__cpp_lib_bitops
+	uint u = static_cast<uint>(v);
+	uint8_t ret = 0;
+	for (; u; u &= u - 1)
+		++ret;
+	return ret;
+#endif//__cpp_lib_bitops
+}
+
 } // namespace bit
 
 #ifndef DLOU_NO_ALIAS
 using bit::bsf;
 using bit::bsr;
+using bit::popcnt;
 #endif
 
 
@@ -2,6 +2,8 @@
 
 #include "node.hpp"
 
+#include <cstddef>
+
 #include <type_traits>
 #include <functional>
 
@@ -101,6 +103,29 @@ public:
 		return ret;
 	}
 
+	// *InputIterator == node&
+	template<class InputIterator>
+	void assign(InputIterator first, InputIterator last) {
+		root_ = build(first, last);
+	}
+
+	// *InputIterator == node&
+	template<class InputIterator>
+	void push_range(InputIterator first, InputIterator last) {
+		node* p = build(first, last);
+		if (p)
+			root_ = root_ ? merge(root_, p) : p;
+	}
+
+	// pop up to k nodes in order to out
+	// Return the end of the output
+	template<class OutputIterator>
+	OutputIterator pop_n(size_t k, OutputIterator out) {
+		for (; k && root_; --k, ++out)
+			*out = pop();
+		return out;
+	}
+
 	//node* fault() const {
 	//	if (!root_)
 	//		return nullptr;
@@ -163,6 +188,36 @@ protected:
 	//	return right ? pos : nullptr;
 	//}
 
+	// bottom-up build in O(n) without allocation
+	// heap[i] holds 2^i nodes, each node is carried in like a binary counter
+	template<class InputIterator>
+	node* build(InputIterator first, InputIterator last) {
+		node* heap[sizeof(size_t) * 8] = {};
+		size_t top = 0;
+
+		for (; first != last; ++first) {
+			node* p = &*first;
+			p->n[0] = nullptr;
+			p->n[1] = nullptr;
+			p->b = 1;
+			size_t i = 0;
+			for (; heap[i]; ++i) {
+				p = merge(heap[i], p);
+				heap[i] = nullptr;
+			}
+			heap[i] = p;
+			if (top <= i)
+				top = i + 1;
+		}
+
+		node* ret = nullptr;
+		for (size_t i = 0; i != top; ++i) {
+			if (heap[i])
+				ret = ret ? merge(heap[i], ret) : heap[i];
+		}
+		return ret;
+	}
+
 protected:
 	node* root_;
 };
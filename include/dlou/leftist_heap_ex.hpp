@@ -139,6 +139,21 @@ public:
 		}
 	}
 
+	// restore the order after the key of p moved toward the top
+	void decrease(node* p) {
+		update(p);
+	}
+
+	// restore the order after the key of p changed in either direction
+	void update(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		erase(p);
+		push(p);
+	}
+
 	//node* fault() const {
 	//	if (!root_)
 	//		return nullptr;
@@ -4,6 +4,8 @@
 
 #define DLOU_NO_ALIAS
 #define DLOU_CHECK_ARGS
+#define DLOU_NO_SIMD
+#define DLOU_CACHE_LINE 64
 
 */
 
@@ -21,6 +23,31 @@
 #define DLOU_IS_CONSTEVAL (std::is_constant_evaluated())
 #endif
 
+#ifndef DLOU_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DLOU_SSE2
+#endif
+#if defined(__SSE4_2__) || defined(__AVX__)
+#define DLOU_SSE42
+#endif
+#ifdef __AVX2__
+#define DLOU_AVX2
+#endif
+#endif//DLOU_NO_SIMD
+
+#ifndef DLOU_CACHE_LINE
+#define DLOU_CACHE_LINE 64
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DLOU_PREFETCH(p) __builtin_prefetch(p)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define DLOU_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0)
+#else
+#define DLOU_PREFETCH(p) ((void)(p))
+#endif
+
 #ifdef __cpp_concepts
 #define DLOU_REQUIRES(...) requires (##__VA_ARGS__)
 #else
@@ -2,6 +2,8 @@
 
 #include <cstddef>
 
+#include <atomic>
+
 namespace dlou {
 
 template<size_t Way, class Key = void, class Balance = void>
@@ -80,6 +82,23 @@ struct node_balance<node<Way, Key, Balance>> {
 template<class Node>
 using node_balance_t = typename node_balance<Node>::type;
 
+namespace _node {
+	// atomic access to the link n[0] of a plain node
+	// without std::atomic_ref, Node* is accessed through std::atomic<Node*>,
+	// which relies on std::atomic<Node*> being lock-free and layout-compatible with Node*
+	template<class Node>
+	decltype(auto) atomic_next(Node* p) {
+#ifdef __cpp_lib_atomic_ref
+		return std::atomic_ref<Node*>(p->n[0]);
+#else
+		static_assert(std::atomic<Node*>::is_always_lock_free
+			&& sizeof(std::atomic<Node*>) == sizeof(Node*)
+			&& alignof(std::atomic<Node*>) == alignof(Node*));
+		return *reinterpret_cast<std::atomic<Node*>*>(&p->n[0]);
+#endif
+	}
+} // namespace _node
+
 template<class Node, class Compare>
 struct node_compare : private Compare {
 	bool operator ()(const Node* a, const Node* b) const {
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "macro.hpp"
+#include "integer.hpp"
+#include "singly_linked_list.hpp"
+#include "buddy.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+#include <utility>
+
+namespace dlou {
+
+namespace _node_pool {
+
+using link = singly_linked_list::node;
+
+// every block is a multiple of granularity and can hold a link while it is free
+static constexpr size_t granularity = alignof(std::max_align_t) < sizeof(link) ? sizeof(link) : alignof(std::max_align_t);
+// classes are spaced by granularity up to linear_limit, and by powers of 2 above it
+static constexpr size_t linear_limit = granularity * 8;
+static constexpr size_t linear_classes = linear_limit / granularity;
+
+constexpr size_t class_size(size_t siz) {
+	siz = siz ? (siz + granularity - 1) / granularity * granularity : granularity;
+	return siz <= linear_limit ? siz : base2::ceil(siz);
+}
+
+constexpr size_t class_index(size_t siz) {
+	siz = class_size(siz);
+	return siz <= linear_limit
+		? siz / granularity - 1
+		: linear_classes - 1 + (base2::log(siz) - base2::log(linear_limit));
+}
+
+// blocks of one size class
+// freed blocks are kept in a free list, new blocks are cut from the newest slab
+// the first granularity bytes of a slab link it in the slab list
+template<size_t SlabSize>
+class size_class
+{
+public:
+	size_class() = default;
+	size_class(const size_class&) = delete;
+	size_class& operator =(const size_class&) = delete;
+
+	size_t slab_count() const { return slab_count_; }
+
+	template<class Source>
+	void* allocate(size_t siz, Source& src) {
+		if (!free_.empty())
+			return free_.pop_front();
+
+		if (static_cast<size_t>(end_ - cur_) < siz) {
+			auto slab = static_cast<char*>(src.allocate(SlabSize));
+			if (!slab)
+				return nullptr;
+			slabs_.push_front(::new (slab) link);
+			++slab_count_;
+			cur_ = slab + granularity;
+			end_ = slab + SlabSize;
+		}
+
+		auto ret = cur_;
+		cur_ += siz;
+		return ret;
+	}
+
+	void deallocate(void* p) {
+		free_.push_front(::new (p) link);
+	}
+
+	// return all slabs to src, blocks in use become invalid
+	template<class Source>
+	void release(Source& src) {
+		while (!slabs_.empty())
+			src.deallocate(slabs_.pop_front(), SlabSize);
+		singly_linked_list().swap(free_);
+		slab_count_ = 0;
+		cur_ = end_ = nullptr;
+	}
+
+private:
+	singly_linked_list free_;
+	singly_linked_list slabs_;
+	size_t slab_count_ = 0;
+	char* cur_ = nullptr;
+	char* end_ = nullptr;
+};
+
+} // namespace _node_pool
+
+
+// slabs from the global heap
+class heap_slab_source
+{
+public:
+	void* allocate(size_t siz) {
+		return ::operator new(siz, std::nothrow);
+	}
+
+	void deallocate(void* p, size_t) {
+		::operator delete(p);
+	}
+};
+
+
+// slabs from one arena of ArenaSize bytes managed by simple_buddy
+// allocate returns nullptr when the arena is full
+template<size_t SlabSize, size_t ArenaSize>
+class buddy_slab_source
+{
+public:
+	using buddy_type = simple_buddy<SlabSize, ArenaSize>;
+
+	static constexpr size_t arena_size = buddy_type::max_size;
+
+	buddy_slab_source()
+		: base_(static_cast<char*>(::operator new(arena_size, std::align_val_t(SlabSize)))) {
+	}
+
+	buddy_slab_source(const buddy_slab_source&) = delete;
+	buddy_slab_source& operator =(const buddy_slab_source&) = delete;
+
+	~buddy_slab_source() {
+		::operator delete(base_, std::align_val_t(SlabSize));
+	}
+
+	const buddy_type& buddy() const { return buddy_; }
+
+	void* allocate(size_t siz) {
+		auto pos = buddy_.allocate(siz);
+		return none == pos ? nullptr : base_ + pos;
+	}
+
+	void deallocate(void* p, size_t siz) {
+		buddy_.release(static_cast<char*>(p) - base_, siz);
+	}
+
+private:
+	buddy_type buddy_;
+	char* base_;
+};
+
+
+// allocator of small blocks grouped by size class
+// blocks of a class share slabs of SlabSize bytes taken from Source
+// slabs are returned to Source only by release or destruction
+// not thread-safe
+template<size_t SlabSize = 4096, class Source = heap_slab_source>
+class size_class_pool
+{
+	static_assert(base2::ispow(SlabSize) && SlabSize >= _node_pool::linear_limit, "Check size_class_pool template args");
+
+public:
+	using source_type = Source;
+
+	static constexpr size_t slab_size = SlabSize;
+	// a slab holds at least 3 blocks of the largest class
+	static constexpr size_t max_size = SlabSize / 4;
+	static constexpr size_t class_count = _node_pool::class_index(max_size) + 1;
+
+	// size of the block allocated for siz bytes
+	static constexpr size_t block_size(size_t siz) {
+		return _node_pool::class_size(siz);
+	}
+
+public:
+	size_class_pool() = default;
+	size_class_pool(const size_class_pool&) = delete;
+	size_class_pool& operator =(const size_class_pool&) = delete;
+
+	~size_class_pool() {
+		release();
+	}
+
+	source_type& source() { return src_; }
+	const source_type& source() const { return src_; }
+
+	size_t slab_count() const {
+		size_t ret = 0;
+		for (auto& c : classes_)
+			ret += c.slab_count();
+		return ret;
+	}
+
+	// Return nullptr if siz > max_size or Source is out of memory
+	void* allocate(size_t siz) {
+		if (max_size < siz)
+			return nullptr;
+		return classes_[_node_pool::class_index(siz)].allocate(block_size(siz), src_);
+	}
+
+	// siz - the argument of allocate
+	void deallocate(void* p, size_t siz) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p || max_size < siz)
+			return;
+#endif
+		classes_[_node_pool::class_index(siz)].deallocate(p);
+	}
+
+	// return all slabs to Source, blocks in use become invalid
+	void release() {
+		for (auto& c : classes_)
+			c.release(src_);
+	}
+
+private:
+	source_type src_;
+	_node_pool::size_class<SlabSize> classes_[class_count];
+};
+
+
+// allocator of objects of type T, typically objects carrying node<Way, Key, Balance> members
+// objects are packed in slabs of SlabSize bytes taken from Source, freed objects are recycled first
+// slabs are returned to Source only by release or destruction
+// not thread-safe
+template<class T, size_t SlabSize = 4096, class Source = heap_slab_source>
+class node_pool
+{
+public:
+	using value_type = T;
+	using pointer = T*;
+	using source_type = Source;
+
+	static constexpr size_t slab_size = SlabSize;
+	static constexpr size_t block_size = _node_pool::class_size(sizeof(T));
+	// objects per slab
+	static constexpr size_t slab_capacity = (SlabSize - _node_pool::granularity) / block_size;
+
+	static_assert(base2::ispow(SlabSize) && slab_capacity, "Check node_pool template args");
+	static_assert(alignof(T) <= _node_pool::granularity, "node_pool does not support over-aligned types");
+
+public:
+	node_pool() = default;
+	node_pool(const node_pool&) = delete;
+	node_pool& operator =(const node_pool&) = delete;
+
+	~node_pool() {
+		release();
+	}
+
+	source_type& source() { return src_; }
+	const source_type& source() const { return src_; }
+
+	size_t slab_count() const { return class_.slab_count(); }
+
+	// uninitialized storage for one T
+	// Return nullptr if Source is out of memory
+	pointer allocate() {
+		return static_cast<pointer>(class_.allocate(block_size, src_));
+	}
+
+	void deallocate(pointer p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		class_.deallocate(p);
+	}
+
+	// Return nullptr if Source is out of memory
+	template<class... Args>
+	pointer create(Args&&... args) {
+		auto p = allocate();
+		if (!p)
+			return nullptr;
+		try {
+			return ::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			deallocate(p);
+			throw;
+		}
+	}
+
+	void destroy(pointer p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		p->~T();
+		class_.deallocate(p);
+	}
+
+	// return all slabs to Source without destroying objects, objects in use become invalid
+	void release() {
+		class_.release(src_);
+	}
+
+private:
+	source_type src_;
+	_node_pool::size_class<SlabSize> class_;
+};
+
+} // namespace dlou
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "node.hpp"
+
+#include <type_traits>
+#include <functional>
+
+namespace dlou {
+
+// n[0] : first child, n[1] : next sibling
+template<class Key>
+using pairing_heap_node = node<2, Key>;
+
+template<class NodeKey
+	, class GetKey = node_key<pairing_heap_node<NodeKey>>
+	, class Compare = std::less<std::remove_cvref_t<std::invoke_result_t<GetKey, const pairing_heap_node<NodeKey>&>>>>
+class basic_pairing_heap
+	: private GetKey
+	, private Compare
+{
+public:
+	using node = pairing_heap_node<NodeKey>;
+	using key_type = std::remove_cvref_t<std::invoke_result_t<GetKey, const node&>>;
+	using key_compare = Compare;
+
+protected:
+	basic_pairing_heap(const basic_pairing_heap&) = default;
+	basic_pairing_heap& operator =(const basic_pairing_heap&) = default;
+
+	basic_pairing_heap& operator =(basic_pairing_heap&& x) {
+		root_ = x.root_;
+		x.root_ = nullptr;
+		return *this;
+	}
+
+	void clear() {
+		root_ = nullptr;
+	}
+
+	const key_type& key(const node& n) const {
+		return GetKey::operator ()(n);
+	}
+
+	bool compare(const node& a, const node& b) const {
+		return Compare::operator ()(key(a), key(b));
+	}
+
+public:
+	basic_pairing_heap()
+		: root_(nullptr) {
+	}
+
+	basic_pairing_heap(basic_pairing_heap&& x)
+		: root_(x.root_) {
+		x.root_ = nullptr;
+	}
+
+	void swap(basic_pairing_heap& x) {
+		auto tmp = root_;
+		root_ = x.root_;
+		x.root_ = tmp;
+	}
+
+	bool empty() const {
+		return !root_;
+	}
+
+	void merge(basic_pairing_heap& x) {
+		node* p = x.root_;
+		if (!p)
+			return;
+		x.root_ = nullptr;
+		root_ = root_ ? link(root_, p) : p;
+	}
+
+	const node* peek() const {
+		return root_;
+	}
+
+	void push(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		p->n[0] = nullptr;
+		p->n[1] = nullptr;
+		root_ = root_ ? link(root_, p) : p;
+	}
+
+	node* pop() {
+		node* ret = root_;
+#ifdef DLOU_CHECK_ARGS
+		if (!ret)
+			return nullptr;
+#endif
+		root_ = combine(ret->n[0]);
+		return ret;
+	}
+
+protected:
+	// p1 and p2 are roots without siblings
+	node* link(node* p1, node* p2) {
+		if (compare(*p2, *p1)) {
+			node* tmp = p1;
+			p1 = p2;
+			p2 = tmp;
+		}
+		p2->n[1] = p1->n[0];
+		p1->n[0] = p2;
+		return p1;
+	}
+
+	// two-pass pairing of a sibling list
+	node* combine(node* first) {
+		// pass 1: link pairs from the left, stack the results through n[1]
+		node* acc = nullptr;
+		while (first) {
+			node* p1 = first;
+			node* p2 = p1->n[1];
+			if (!p2) {
+				p1->n[1] = acc;
+				acc = p1;
+				break;
+			}
+			first = p2->n[1];
+			p1->n[1] = nullptr;
+			p2->n[1] = nullptr;
+			p1 = link(p1, p2);
+			p1->n[1] = acc;
+			acc = p1;
+		}
+
+		// pass 2: link the results from the right
+		if (!acc)
+			return nullptr;
+		node* ret = acc;
+		acc = acc->n[1];
+		ret->n[1] = nullptr;
+		while (acc) {
+			node* nxt = acc->n[1];
+			acc->n[1] = nullptr;
+			ret = link(ret, acc);
+			acc = nxt;
+		}
+		return ret;
+	}
+
+protected:
+	node* root_;
+};
+
+template<class Key, class Compare = std::less<Key>>
+using pairing_heap = basic_pairing_heap<Key, node_key<pairing_heap_node<Key>>, Compare>;
+
+} // namespace dlou
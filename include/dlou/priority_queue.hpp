@@ -38,6 +38,19 @@ namespace _priority_queue {
 		{ heap.push((typename Container::node*)nullptr) };
 		{ heap.pop() } -> std::same_as<typename Container::node*>;
 	};
+
+	template<class Container>
+	concept erasable_heap = requires (Container heap)
+	{
+		{ heap.erase((typename Container::node*)nullptr) };
+	};
+
+	template<class Container>
+	concept updatable_heap = requires (Container heap)
+	{
+		{ heap.decrease((typename Container::node*)nullptr) };
+		{ heap.update((typename Container::node*)nullptr) };
+	};
 #endif//__cpp_concepts
 } // namespace _priority_queue
 
@@ -88,6 +101,26 @@ public:
 	void push(value_type* p) { heap_.push(to_node(p)); }
 	value_type* pop() { return to_object(heap_.pop()); }
 
+	// for containers with erase(node*)
+	void erase(value_type* p)
+		DLOU_REQUIRES(_priority_queue::erasable_heap<Container>) {
+		heap_.erase(to_node(p));
+	}
+
+	// call after the key of p moved toward the top, for containers with decrease(node*)
+	// O(1) on pairing_heap_ex
+	void decrease(value_type* p)
+		DLOU_REQUIRES(_priority_queue::updatable_heap<Container>) {
+		heap_.decrease(to_node(p));
+	}
+
+	// call after the key of p changed in either direction, for containers with update(node*)
+	// erase and push on the linked heaps
+	void update(value_type* p)
+		DLOU_REQUIRES(_priority_queue::updatable_heap<Container>) {
+		heap_.update(to_node(p));
+	}
+
 private:
 	container_type heap_;
 };
@@ -2,10 +2,12 @@
 
 #include "macro.hpp"
 #include "static.hpp"
+#include "node.hpp"
 #include "circular/singly_linked_list.hpp"
 
 #include <cstddef>
 
+#include <atomic>
 #include <type_traits>
 #ifdef __cpp_concepts
 #include <concepts>
@@ -86,4 +88,111 @@ private:
 	container_type list_;
 };
 
+
+// lock-free intrusive multi-producer single-consumer queue (Vyukov)
+// push never blocks and may be called from any thread
+// front, pop and empty may only be called from one consumer thread
+// an object must not be pushed again before it is popped
+template<auto MemberObjPtr>
+DLOU_REQUIRES(
+	std::is_member_object_pointer_v<decltype(MemberObjPtr)>&& MemberObjPtr != nullptr &&
+	std::is_same_v<node<1>, _queue::node_t<MemberObjPtr>>)
+class mpsc_queue
+{
+public:
+	using member_object_type = decltype(MemberObjPtr);
+	using value_type = remove_member_t<member_object_type>;
+	using node = member_t<member_object_type>;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+
+protected:
+	static node* to_node(const_pointer p) {
+		return &(const_cast<pointer>(p)->*MemberObjPtr);
+	}
+
+	static pointer to_object(const node* p) {
+		return (pointer)((char*)p - (ptrdiff_t)(&(((pointer)0)->*MemberObjPtr)));
+	}
+
+	static node* load_next(const node* p) {
+		return _node::atomic_next(const_cast<node*>(p)).load(std::memory_order_acquire);
+	}
+
+	void push_node(node* p) {
+		_node::atomic_next(p).store(nullptr, std::memory_order_relaxed);
+		node* prv = head_.exchange(p, std::memory_order_acq_rel);
+		// the queue is broken between prv and p until this store
+		_node::atomic_next(prv).store(p, std::memory_order_release);
+	}
+
+public:
+	mpsc_queue()
+		: head_(&stub_), tail_(&stub_) {
+		stub_.n[0] = nullptr;
+	}
+
+	mpsc_queue(const mpsc_queue&) = delete;
+	mpsc_queue& operator =(const mpsc_queue&) = delete;
+
+	bool empty() const {
+		return &stub_ == tail_ && !load_next(&stub_);
+	}
+
+	// Return nullptr if empty
+	const_pointer front() const {
+		const node* cur = &stub_ == tail_ ? load_next(&stub_) : tail_;
+		return cur ? to_object(cur) : nullptr;
+	}
+
+	void push(pointer p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p)
+			return;
+#endif
+		push_node(to_node(p));
+	}
+
+	// Return nullptr if empty, or if the only object left is still being pushed
+	pointer pop() {
+		node* cur = tail_;
+		node* nxt = load_next(cur);
+
+		// skip the stub
+		if (&stub_ == cur) {
+			if (!nxt)
+				return nullptr;
+			tail_ = cur = nxt;
+			nxt = load_next(cur);
+		}
+
+		if (nxt) {
+			tail_ = nxt;
+			return to_object(cur);
+		}
+
+		// cur is the last linked node, a producer may be linking behind it
+		if (cur != head_.load(std::memory_order_acquire))
+			return nullptr;
+
+		// re-insert the stub so that cur can be unlinked
+		push_node(&stub_);
+		nxt = load_next(cur);
+		if (nxt) {
+			tail_ = nxt;
+			return to_object(cur);
+		}
+		return nullptr;
+	}
+
+private:
+	// producers
+	alignas(DLOU_CACHE_LINE) std::atomic<node*> head_;
+	// consumer
+	alignas(DLOU_CACHE_LINE) node* tail_;
+	node stub_;
+};
+
 } // namespace dlou
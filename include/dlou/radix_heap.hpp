@@ -0,0 +1,182 @@
+#pragma once
+
+#include "node.hpp"
+#include "integer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <type_traits>
+#include <functional>
+
+namespace dlou {
+
+template<class Key>
+using radix_heap_node = node<1, Key>;
+
+// monotone min-heap of unsigned integer keys
+// a key must not be less than last(), the last popped key
+// bucket 0 holds the keys equal to last(), bucket b holds the keys whose highest bit differing from last() is b - 1
+// pop refills bucket 0 from the lowest non-empty bucket,
+// each node moves to a lower bucket at most once per bit, so push and pop are O(1) amortized
+template<class NodeKey
+	, class GetKey = node_key<radix_heap_node<NodeKey>>>
+class basic_radix_heap
+	: private GetKey
+{
+public:
+	using node = radix_heap_node<NodeKey>;
+	using key_type = std::remove_cvref_t<std::invoke_result_t<GetKey, const node&>>;
+	using key_compare = std::less<key_type>;
+
+	static_assert(std::is_unsigned_v<key_type> && sizeof(key_type) <= sizeof(uint64_t), "radix_heap requires an unsigned integer key");
+
+	static constexpr size_t bucket_count = sizeof(key_type) * 8 + 1;
+
+protected:
+	basic_radix_heap(const basic_radix_heap&) = default;
+	basic_radix_heap& operator =(const basic_radix_heap&) = default;
+
+	basic_radix_heap& operator =(basic_radix_heap&& x) {
+		*this = x;
+		x.clear();
+		return *this;
+	}
+
+	void clear() {
+		for (auto& b : bucket_)
+			b = nullptr;
+		mask_ = 0;
+		size_ = 0;
+		last_ = 0;
+	}
+
+	const key_type& key(const node& n) const {
+		return GetKey::operator ()(n);
+	}
+
+	size_t bucket(const key_type& k) const {
+		return k == last_ ? 0 : bit::bsr(k ^ last_) + 1;
+	}
+
+	const node* min_of(const node* p) const {
+		const node* ret = p;
+		for (p = p->n[0]; p; p = p->n[0]) {
+			if (key(*p) < key(*ret))
+				ret = p;
+		}
+		return ret;
+	}
+
+	void link(node* p) {
+		const auto b = bucket(key(*p));
+		p->n[0] = bucket_[b];
+		bucket_[b] = p;
+		if (b)
+			mask_ |= uint64_t(1) << (b - 1);
+	}
+
+	// move the lowest non-empty bucket down, its minimum becomes last()
+	void refill() {
+		const auto b = bit::bsf(mask_) + 1;
+		mask_ &= mask_ - 1;
+		node* p = bucket_[b];
+		bucket_[b] = nullptr;
+
+		last_ = key(*min_of(p));
+		while (p) {
+			node* nxt = p->n[0];
+			link(p);
+			p = nxt;
+		}
+	}
+
+public:
+	basic_radix_heap() {
+		clear();
+	}
+
+	basic_radix_heap(basic_radix_heap&& x)
+		: basic_radix_heap(x) {
+		x.clear();
+	}
+
+	void swap(basic_radix_heap& x) {
+		auto tmp = *this;
+		*this = x;
+		x = tmp;
+	}
+
+	bool empty() const {
+		return !size_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	// the key of the last popped node, a lower bound of all keys
+	// merge takes the smaller one
+	key_type last() const {
+		return last_;
+	}
+
+	// O(size of the heap with the larger minimum)
+	void merge(basic_radix_heap& x) {
+		if (x.empty())
+			return;
+		if (empty() || x.last_ < last_)
+			swap(x);
+
+		size_ += x.size_;
+		for (auto& b : x.bucket_) {
+			for (node* p = b; p; ) {
+				node* nxt = p->n[0];
+				link(p);
+				p = nxt;
+			}
+		}
+		x.clear();
+	}
+
+	// O(1) if the top is in bucket 0, otherwise scan the lowest non-empty bucket
+	const node* peek() const {
+		if (bucket_[0])
+			return bucket_[0];
+		return mask_ ? min_of(bucket_[bit::bsf(mask_) + 1]) : nullptr;
+	}
+
+	void push(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p || key(*p) < last_)
+			return;
+#endif
+		link(p);
+		++size_;
+	}
+
+	node* pop() {
+#ifdef DLOU_CHECK_ARGS
+		if (empty())
+			return nullptr;
+#endif
+		if (!bucket_[0])
+			refill();
+		node* ret = bucket_[0];
+		bucket_[0] = ret->n[0];
+		--size_;
+		return ret;
+	}
+
+protected:
+	node* bucket_[bucket_count];
+	// bit b - 1 : bucket b is not empty
+	uint64_t mask_;
+	size_t size_;
+	key_type last_;
+};
+
+template<class Key>
+using radix_heap = basic_radix_heap<Key, node_key<radix_heap_node<Key>>>;
+
+} // namespace dlou
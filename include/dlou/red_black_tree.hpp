@@ -6,17 +6,17 @@
 
 namespace dlou {
 
-template<class Key, class Compare = std::less<Key>>
+template<class Key, class Compare = std::less<Key>, class Augment = void>
 class red_black_tree
-	: public basic_bst<Key, Compare, bool>
+	: public basic_bst<Key, Compare, bool, Augment>
 {
-	using basic_type = basic_bst<Key, Compare, bool>;
+	using basic_type = basic_bst<Key, Compare, bool, Augment>;
 public:
 	using typename basic_type::key_type;
 	using typename basic_type::node;
 	using typename basic_type::iterator;
 
-	using color_type = node_balance_t<node>;
+	using color_type = typename basic_type::balance_type;
 	static constexpr color_type black = 0;
 	static constexpr color_type red = 1;
 
@@ -24,12 +24,13 @@ protected:
 	using basic_type::root_;
 	using basic_type::_parent;
 	using basic_type::_rotate;
+	using basic_type::_update_path;
 	using basic_type::compare;
 	using basic_type::make_iterator;
 
 protected:
-	static color_type color(const node* p) { return p->b; }
-	static color_type& color(node* p) { return p->b; }
+	static color_type color(const node* p) { return basic_type::balance(p); }
+	static color_type& color(node* p) { return basic_type::balance(p); }
 
 	static bool is_red(const node* p) {
 		static_assert(red == true, "Check color value");
@@ -52,6 +53,9 @@ protected:
 		if (child && (pos != _parent(child) || compare(child->k, pos->k)))
 			throw(pos);
 
+		if (basic_type::_fault_augment(pos))
+			throw(pos);
+
 		size_t n = _fault(pos->n[0]);
 		if (n != _fault(pos->n[1]))
 			throw(pos);
@@ -74,6 +78,7 @@ protected:
 		p->n[0] = p->n[1] = nullptr;
 		color(p) = red;
 		*branch = p;
+		_update_path(p);
 
 		node* grand;
 		node* uncle;
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "macro.hpp"
+#include "integer.hpp"
+#include "defer_construct.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+namespace dlou {
+
+namespace _ring_buffer {
+
+constexpr size_t capacity(size_t n) {
+	return base2::ceil(n < 2 ? size_t(2) : n);
+}
+
+} // namespace _ring_buffer
+
+
+// bounded single-producer single-consumer ring buffer
+// push may only be called from one producer thread, pop from one consumer thread
+// each side caches the other side's index and reads it again only when the buffer looks full or empty
+template<class T, size_t Capacity>
+class spsc_ring_buffer
+{
+public:
+	using value_type = T;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+
+	// Capacity rounded up to 2^n
+	static constexpr size_t capacity = _ring_buffer::capacity(Capacity);
+
+private:
+	static constexpr size_t mask = capacity - 1;
+
+	// producer: number of free slots, at most n
+	size_t writable(size_t n) {
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		if (capacity - (tail - head_cache_) < n)
+			head_cache_ = head_.load(std::memory_order_acquire);
+		const auto free = capacity - (tail - head_cache_);
+		return free < n ? free : n;
+	}
+
+	// consumer: number of stored objects, at most n
+	size_t readable(size_t n) {
+		const auto head = head_.load(std::memory_order_relaxed);
+		if (tail_cache_ - head < n)
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+		const auto used = tail_cache_ - head;
+		return used < n ? used : n;
+	}
+
+public:
+	spsc_ring_buffer() = default;
+	spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+	spsc_ring_buffer& operator =(const spsc_ring_buffer&) = delete;
+
+	~spsc_ring_buffer() {
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		for (auto i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+			slots_[i & mask].destroy();
+	}
+
+	// approximate when called while the other side is active
+	// head first, the consumer never passes a tail read after it
+	size_t size() const {
+		const auto head = head_.load(std::memory_order_acquire);
+		const auto tail = tail_.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	bool empty() const { return !size(); }
+
+	// producer
+	// Return false if full
+	template<class... Args>
+	bool emplace(Args&&... args) {
+		if (!writable(1))
+			return false;
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		slots_[tail & mask].construct(std::forward<Args>(args)...);
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool push(const value_type& x) { return emplace(x); }
+	bool push(value_type&& x) { return emplace(std::move(x)); }
+
+	// producer
+	// copy up to n objects from first, publish them at once
+	// Return the number of objects pushed
+	template<class InputIterator>
+	size_t push_n(InputIterator first, size_t n) {
+		n = writable(n);
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		for (size_t i = 0; i != n; ++i, ++first)
+			slots_[(tail + i) & mask].construct(*first);
+		tail_.store(tail + n, std::memory_order_release);
+		return n;
+	}
+
+	// consumer
+	// Return false if empty
+	bool pop(value_type& x) {
+		if (!readable(1))
+			return false;
+		const auto head = head_.load(std::memory_order_relaxed);
+		auto& slot = slots_[head & mask];
+		x = std::move(*slot);
+		slot.destroy();
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer
+	// move up to n objects to out, release their slots at once
+	// Return the number of objects popped
+	template<class OutputIterator>
+	size_t pop_n(OutputIterator out, size_t n) {
+		n = readable(n);
+		const auto head = head_.load(std::memory_order_relaxed);
+		for (size_t i = 0; i != n; ++i, ++out) {
+			auto& slot = slots_[(head + i) & mask];
+			*out = std::move(*slot);
+			slot.destroy();
+		}
+		head_.store(head + n, std::memory_order_release);
+		return n;
+	}
+
+private:
+	// consumer
+	alignas(DLOU_CACHE_LINE) std::atomic<size_t> head_{ 0 };
+	size_t tail_cache_ = 0;
+	// producer
+	alignas(DLOU_CACHE_LINE) std::atomic<size_t> tail_{ 0 };
+	size_t head_cache_ = 0;
+
+	alignas(DLOU_CACHE_LINE) manual_object<T> slots_[capacity];
+};
+
+
+// bounded multi-producer multi-consumer ring buffer (Vyukov)
+// each slot carries a sequence number telling whether it is ready to be written or read in the current lap,
+// so producers and consumers only contend on their own index
+template<class T, size_t Capacity>
+class mpmc_ring_buffer
+{
+public:
+	using value_type = T;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+
+	// Capacity rounded up to 2^n
+	static constexpr size_t capacity = _ring_buffer::capacity(Capacity);
+
+private:
+	static constexpr size_t mask = capacity - 1;
+
+	struct slot {
+		std::atomic<size_t> seq;
+		manual_object<T> obj;
+	};
+
+	// claim up to n consecutive slots whose sequence is pos + i + Lap
+	// Return the number of slots claimed, pos is the first one
+	template<size_t Lap>
+	size_t claim(std::atomic<size_t>& index, size_t& pos, size_t n) {
+		pos = index.load(std::memory_order_relaxed);
+		for (;;) {
+			size_t cnt = 0;
+			for (; cnt != n; ++cnt) {
+				const auto seq = slots_[(pos + cnt) & mask].seq.load(std::memory_order_acquire);
+				const auto dif = static_cast<intptr_t>(seq - (pos + cnt + Lap));
+				if (dif)
+					break;
+			}
+
+			if (!cnt) {
+				// the first slot is not ready: full or empty, unless another thread moved the index
+				const auto cur = index.load(std::memory_order_relaxed);
+				if (cur == pos)
+					return 0;
+				pos = cur;
+				continue;
+			}
+
+			if (index.compare_exchange_weak(pos, pos + cnt, std::memory_order_relaxed, std::memory_order_relaxed))
+				return cnt;
+		}
+	}
+
+public:
+	mpmc_ring_buffer() {
+		for (size_t i = 0; i != capacity; ++i)
+			slots_[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+	mpmc_ring_buffer& operator =(const mpmc_ring_buffer&) = delete;
+
+	~mpmc_ring_buffer() {
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		for (auto i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+			slots_[i & mask].obj.destroy();
+	}
+
+	// approximate, counts objects being pushed or popped
+	size_t size() const {
+		const auto head = head_.load(std::memory_order_acquire);
+		const auto tail = tail_.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+
+	bool empty() const { return !size(); }
+
+	// Return false if full
+	template<class... Args>
+	bool emplace(Args&&... args) {
+		size_t pos;
+		if (!claim<0>(tail_, pos, 1))
+			return false;
+		auto& s = slots_[pos & mask];
+		s.obj.construct(std::forward<Args>(args)...);
+		s.seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool push(const value_type& x) { return emplace(x); }
+	bool push(value_type&& x) { return emplace(std::move(x)); }
+
+	// copy up to n objects from first, the slots are claimed with one compare-and-swap
+	// Return the number of objects pushed
+	template<class InputIterator>
+	size_t push_n(InputIterator first, size_t n) {
+		size_t pos;
+		n = n ? claim<0>(tail_, pos, n) : 0;
+		for (size_t i = 0; i != n; ++i, ++first) {
+			auto& s = slots_[(pos + i) & mask];
+			s.obj.construct(*first);
+			s.seq.store(pos + i + 1, std::memory_order_release);
+		}
+		return n;
+	}
+
+	// Return false if empty
+	bool pop(value_type& x) {
+		size_t pos;
+		if (!claim<1>(head_, pos, 1))
+			return false;
+		auto& s = slots_[pos & mask];
+		x = std::move(*s.obj);
+		s.obj.destroy();
+		s.seq.store(pos + capacity, std::memory_order_release);
+		return true;
+	}
+
+	// move up to n objects to out, the slots are claimed with one compare-and-swap
+	// Return the number of objects popped
+	template<class OutputIterator>
+	size_t pop_n(OutputIterator out, size_t n) {
+		size_t pos;
+		n = n ? claim<1>(head_, pos, n) : 0;
+		for (size_t i = 0; i != n; ++i, ++out) {
+			auto& s = slots_[(pos + i) & mask];
+			*out = std::move(*s.obj);
+			s.obj.destroy();
+			s.seq.store(pos + i + capacity, std::memory_order_release);
+		}
+		return n;
+	}
+
+private:
+	// consumers
+	alignas(DLOU_CACHE_LINE) std::atomic<size_t> head_{ 0 };
+	// producers
+	alignas(DLOU_CACHE_LINE) std::atomic<size_t> tail_{ 0 };
+
+	alignas(DLOU_CACHE_LINE) slot slots_[capacity];
+};
+
+} // namespace dlou
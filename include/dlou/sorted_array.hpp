@@ -1,15 +1,151 @@
 #pragma once
 
 #include "macro.hpp"
+#include "static.hpp"
+#include "integer.hpp"
 
 #include <cstddef>
+#include <cstdint>
 
 #include <type_traits>
+#include <algorithm>
+#include <iterator>
 #include <utility>
 #include <functional>
 
+#ifdef DLOU_AVX2
+#include <immintrin.h>
+#elif defined(DLOU_SSE42)
+#include <nmmintrin.h>
+#elif defined(DLOU_SSE2)
+#include <emmintrin.h>
+#endif
+
 namespace dlou {
 
+// tag: the input is already sorted by key_compare
+struct presorted_t {
+	explicit presorted_t() = default;
+};
+inline constexpr presorted_t presorted{};
+
+namespace _sorted_array {
+
+// compare lanes, width == 0 if not supported
+template<class T, class = void>
+struct simd {
+	static constexpr size_t width = 0;
+};
+
+#ifdef DLOU_AVX2
+template<>
+struct simd<float> {
+	using type = __m256;
+	static constexpr size_t width = 8;
+	static type load(const float* p) { return _mm256_loadu_ps(p); }
+	static type set(float v) { return _mm256_set1_ps(v); }
+	static int less(type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+};
+
+template<>
+struct simd<double> {
+	using type = __m256d;
+	static constexpr size_t width = 4;
+	static type load(const double* p) { return _mm256_loadu_pd(p); }
+	static type set(double v) { return _mm256_set1_pd(v); }
+	static int less(type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+};
+
+// unsigned compare as signed by flipping the sign bit
+template<class T>
+struct simd<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 4>> {
+	using type = __m256i;
+	static constexpr size_t width = 8;
+	static constexpr int32_t bias = std::is_signed<T>::value ? 0 : INT32_MIN;
+	static type load(const T* p) { return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const type*>(p)), _mm256_set1_epi32(bias)); }
+	static type set(T v) { return _mm256_set1_epi32(static_cast<int32_t>(v) ^ bias); }
+	static int less(type a, type b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))); }
+};
+
+template<class T>
+struct simd<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 8>> {
+	using type = __m256i;
+	static constexpr size_t width = 4;
+	static constexpr int64_t bias = std::is_signed<T>::value ? 0 : INT64_MIN;
+	static type load(const T* p) { return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const type*>(p)), _mm256_set1_epi64x(bias)); }
+	static type set(T v) { return _mm256_set1_epi64x(static_cast<int64_t>(v) ^ bias); }
+	static int less(type a, type b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a))); }
+};
+#elif defined(DLOU_SSE2)
+template<>
+struct simd<float> {
+	using type = __m128;
+	static constexpr size_t width = 4;
+	static type load(const float* p) { return _mm_loadu_ps(p); }
+	static type set(float v) { return _mm_set1_ps(v); }
+	static int less(type a, type b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+};
+
+template<>
+struct simd<double> {
+	using type = __m128d;
+	static constexpr size_t width = 2;
+	static type load(const double* p) { return _mm_loadu_pd(p); }
+	static type set(double v) { return _mm_set1_pd(v); }
+	static int less(type a, type b) { return _mm_movemask_pd(_mm_cmplt_pd(a, b)); }
+};
+
+// unsigned compare as signed by flipping the sign bit
+template<class T>
+struct simd<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 4>> {
+	using type = __m128i;
+	static constexpr size_t width = 4;
+	static constexpr int32_t bias = std::is_signed<T>::value ? 0 : INT32_MIN;
+	static type load(const T* p) { return _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const type*>(p)), _mm_set1_epi32(bias)); }
+	static type set(T v) { return _mm_set1_epi32(static_cast<int32_t>(v) ^ bias); }
+	static int less(type a, type b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(a, b))); }
+};
+
+#ifdef DLOU_SSE42
+template<class T>
+struct simd<T, std::enable_if_t<std::is_integral<T>::value && sizeof(T) == 8>> {
+	using type = __m128i;
+	static constexpr size_t width = 2;
+	static constexpr int64_t bias = std::is_signed<T>::value ? 0 : INT64_MIN;
+	static type load(const T* p) { return _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const type*>(p)), _mm_set1_epi64x(bias)); }
+	static type set(T v) { return _mm_set1_epi64x(static_cast<int64_t>(v) ^ bias); }
+	static int less(type a, type b) { return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(b, a))); }
+};
+#endif//DLOU_SSE42
+#endif
+
+// number of p[i] < k, or k < p[i] if Greater
+template<bool Greater, class T>
+inline size_t count(const T* p, size_t n, T k)
+{
+	using lane = simd<T>;
+	size_t ret = 0;
+	size_t i = 0;
+	if constexpr (lane::width > 0) {
+		const auto key = lane::set(k);
+		for (; i + lane::width <= n; i += lane::width) {
+			if constexpr (Greater)
+				ret += bit::popcnt(lane::less(key, lane::load(p + i)));
+			else
+				ret += bit::popcnt(lane::less(lane::load(p + i), key));
+		}
+	}
+	for (; i < n; ++i) {
+		if constexpr (Greater)
+			ret += k < p[i];
+		else
+			ret += p[i] < k;
+	}
+	return ret;
+}
+
+} // namespace _sorted_array
+
 template<size_t N, class Key, class Val = void, class Compare = std::less<Key>>
 DLOU_REQUIRES(N > 0)
 class sorted_array;
@@ -23,6 +159,9 @@ constexpr auto merge(const sorted_array<N1, Key, Val, Compare1>&, const std::pai
 template<class = void, class Key, size_t N1, class Compare1, size_t N2>
 constexpr auto merge(const sorted_array<N1, Key, void, Compare1>&, const Key(&)[N2]);
 
+template<class = void, class Key, class Val, size_t N1, class Compare1, size_t N2, class Compare2, size_t N3, class Compare3, size_t... Ns, class... Compares>
+constexpr auto merge(const sorted_array<N1, Key, Val, Compare1>&, const sorted_array<N2, Key, Val, Compare2>&, const sorted_array<N3, Key, Val, Compare3>&, const sorted_array<Ns, Key, Val, Compares>&...);
+
 template<size_t N, class Key, class Val, class Compare>
 DLOU_REQUIRES(N > 0)
 class sorted_array
@@ -36,6 +175,9 @@ class sorted_array
 	template<class, class Key, size_t N1, class Compare1, size_t N2>
 	friend constexpr auto merge(const sorted_array<N1, Key, void, Compare1>&, const Key(&)[N2]);
 
+	template<class, class Key, class Val, size_t N1, class Compare1, size_t N2, class Compare2, size_t N3, class Compare3, size_t... Ns, class... Compares>
+	friend constexpr auto merge(const sorted_array<N1, Key, Val, Compare1>&, const sorted_array<N2, Key, Val, Compare2>&, const sorted_array<N3, Key, Val, Compare3>&, const sorted_array<Ns, Key, Val, Compares>&...);
+
 public:
 	using key_type = Key;
 	using mapped_type = typename std::conditional<std::is_same<void, Val>::value, Key, Val>::type;
@@ -51,6 +193,17 @@ public:
 		}
 	};
 
+private:
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<key_compare>, K>;
+
+	// arithmetic keys ordered by std::less, narrow by branchless steps then count the rest linearly
+	template<class K>
+	static constexpr bool linear_search = std::is_arithmetic<key_type>::value && std::is_same<K, key_type>::value
+		&& (std::is_same<key_compare, std::less<key_type>>::value || std::is_same<key_compare, std::less<>>::value);
+
+	static constexpr size_t linear_size = 128 / sizeof(value_type) < 16 ? 16 : 128 / sizeof(value_type) > 64 ? 64 : 128 / sizeof(value_type);
+
 public:
 	constexpr sorted_array(const sorted_array&) = default;
 	constexpr sorted_array& operator =(const sorted_array&) = default;
@@ -64,6 +217,11 @@ public:
 		return *this;
 	}
 
+	// adopt x without sorting, x must be sorted by key_compare
+	constexpr sorted_array(presorted_t, const value_type(&x)[N]) {
+		copy(x);
+	}
+
 	template<class OldCompare>
 	constexpr sorted_array(const sorted_array<N, Key, Val, OldCompare>& x) {
 		clone(x.data());
@@ -83,21 +241,98 @@ public:
 	constexpr const mapped_type& operator [](const key_type& k) const { return get_val(*find(k)); }
 
 	constexpr const mapped_type& at(const key_type& k, const mapped_type& invalid = mapped_type{}) const {
-		auto ret = lower_bound(k);
-		if (Compare{}(k, get_key(*ret)))
+		return _at(k, invalid);
+	}
+
+	constexpr pointer find(const key_type& k) const {
+		return _find(k);
+	}
+
+	constexpr pointer lower_bound(const key_type& k) const {
+		return _lower_bound(k);
+	}
+
+	constexpr pointer upper_bound(const key_type& k) const {
+		return _upper_bound(k);
+	}
+
+	constexpr std::pair<pointer, pointer> equal_range(const key_type& k) const {
+		return _range(k, k);
+	}
+
+	constexpr std::pair<pointer, pointer> range(const key_type& min_key, const key_type& max_key) const {
+		return _range(min_key, max_key);
+	}
+
+	// number of keys less than k
+	constexpr size_t count_less(const key_type& k) const {
+		return _lower_bound(k) - arr_;
+	}
+
+	// transparent key_compare
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& operator [](const K& k) const { return get_val(*_find(k)); }
+
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		return _at(k, invalid);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer find(const K& k) const {
+		return _find(k);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer lower_bound(const K& k) const {
+		return _lower_bound(k);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr pointer upper_bound(const K& k) const {
+		return _upper_bound(k);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr std::pair<pointer, pointer> equal_range(const K& k) const {
+		return _range(k, k);
+	}
+
+	template<class K1, class K2, class = transparent_t<K1>, class = transparent_t<K2>>
+	constexpr std::pair<pointer, pointer> range(const K1& min_key, const K2& max_key) const {
+		return _range(min_key, max_key);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr size_t count_less(const K& k) const {
+		return _lower_bound(k) - arr_;
+	}
+
+private:
+	sorted_array() = default;
+
+	template<class K>
+	constexpr const mapped_type& _at(const K& k, const mapped_type& invalid) const {
+		auto ret = _lower_bound(k);
+		if (end() == ret || Compare{}(k, get_key(*ret)))
 			return invalid;
 		return get_val(*ret);
 	}
 
-	constexpr pointer find(const key_type& k) const {
+	template<class K>
+	constexpr pointer _find(const K& k) const {
 		const auto invalid = end();
-		auto ret = lower_bound(k);
+		auto ret = _lower_bound(k);
 		if (invalid == ret || Compare{}(k, get_key(*ret)))
 			return end();
 		return ret;
 	}
 
-	constexpr pointer lower_bound(const key_type& k) const {
+	template<class K>
+	constexpr pointer _lower_bound(const K& k) const {
+		if constexpr (linear_search<K>)
+			return linear_bound<false>(k);
+
 		Compare cmp;
 		size_t l = 0;
 		size_t r = N;
@@ -112,7 +347,11 @@ public:
 		return arr_ + l;
 	}
 
-	constexpr pointer upper_bound(const key_type& k) const {
+	template<class K>
+	constexpr pointer _upper_bound(const K& k) const {
+		if constexpr (linear_search<K>)
+			return linear_bound<true>(k);
+
 		Compare cmp;
 		size_t l = 0;
 		size_t r = N;
@@ -127,11 +366,11 @@ public:
 		return arr_ + l;
 	}
 
-	constexpr std::pair<pointer, pointer> equal_range(const key_type& k) const {
-		return range(k, k);
-	}
+	template<class K1, class K2>
+	constexpr std::pair<pointer, pointer> _range(const K1& min_key, const K2& max_key) const {
+		if constexpr (linear_search<K1> && linear_search<K2>)
+			return { linear_bound<false>(min_key), linear_bound<true>(max_key) };
 
-	constexpr std::pair<pointer, pointer> range(const key_type& min_key, const key_type& max_key) const {
 		Compare cmp;
 		pointer first;
 		size_t l = 0;
@@ -157,12 +396,48 @@ public:
 		return { first, arr_ + l };
 	}
 
-private:
-	sorted_array() = default;
+	// Upper ? upper_bound : lower_bound
+	template<bool Upper>
+	constexpr pointer linear_bound(const key_type& k) const {
+		pointer base = arr_;
+		size_t n = N;
+		while (n > linear_size) {
+			const size_t half = n / 2;
+			if constexpr (Upper)
+				base += !(k < get_key(base[half])) ? half : 0;
+			else
+				base += get_key(base[half]) < k ? half : 0;
+			n -= half;
+		}
 
-	constexpr void clone(const value_type* p) {
+		if constexpr (std::is_same<void, Val>::value) {
+			if DLOU_IS_CONSTEVAL {
+			}
+			else {
+				if constexpr (Upper)
+					return base + (n - _sorted_array::count<true>(base, n, k));
+				else
+					return base + _sorted_array::count<false>(base, n, k);
+			}
+		}
+
+		size_t cnt = 0;
+		for (size_t i = 0; i < n; ++i) {
+			if constexpr (Upper)
+				cnt += !(k < get_key(base[i]));
+			else
+				cnt += get_key(base[i]) < k;
+		}
+		return base + cnt;
+	}
+
+	constexpr void copy(const value_type* p) {
 		for (auto& v : arr_)
 			v = *p++;
+	}
+
+	constexpr void clone(const value_type* p) {
+		copy(p);
 		sort();
 	}
 
@@ -183,14 +458,99 @@ private:
 		sort(arr_, N);
 	}
 
+	// stable, equal keys keep the input order
 	static constexpr void sort(value_type* beg, size_t siz) {
-		Compare cmp;
-		for (size_t i = siz - 1; i > 0; --i) {
-			for (size_t j = 0; j < i; ++j) {
-				auto* p1 = beg + j;
-				auto* p2 = p1 + 1;
-				if (cmp(get_key(*p2), get_key(*p1)))
-					std::swap(*p1, *p2);
+		if DLOU_IS_CONSTEVAL {
+			merge_sort(beg, siz);
+		}
+		else {
+			std::stable_sort(beg, beg + siz, value_compare{});
+		}
+	}
+
+	// bottom-up merge sort, insertion sorted runs then merge by ping-pong buffer
+	static constexpr void merge_sort(value_type* beg, size_t siz) {
+		constexpr size_t run = 8;
+		value_compare cmp;
+
+		for (size_t i = 0; i < siz; i += run) {
+			const size_t last = std::min(i + run, siz);
+			for (size_t j = i + 1; j < last; ++j) {
+				value_type tmp = std::move(beg[j]);
+				size_t k = j;
+				for (; k > i && cmp(tmp, beg[k - 1]); --k)
+					beg[k] = std::move(beg[k - 1]);
+				beg[k] = std::move(tmp);
+			}
+		}
+
+		if (siz <= run)
+			return;
+
+		value_type* buf = new value_type[siz];
+		value_type* src = beg;
+		value_type* dst = buf;
+
+		for (size_t width = run; width < siz; width *= 2) {
+			for (size_t l = 0; l < siz; l += width * 2) {
+				const size_t m = std::min(l + width, siz);
+				const size_t r = std::min(m + width, siz);
+				size_t i = l;
+				size_t j = m;
+				size_t k = l;
+				while (i < m && j < r)
+					dst[k++] = std::move(cmp(src[j], src[i]) ? src[j++] : src[i++]);
+				while (i < m)
+					dst[k++] = std::move(src[i++]);
+				while (j < r)
+					dst[k++] = std::move(src[j++]);
+			}
+			std::swap(src, dst);
+		}
+
+		if (src != beg) {
+			for (size_t i = 0; i < siz; ++i)
+				beg[i] = std::move(src[i]);
+		}
+		delete[] buf;
+	}
+
+	// k-way merge by loser tree, equal keys are taken from the earlier run first
+	template<size_t K>
+	static constexpr void merge_runs(value_type* dst, pointer(&pos)[K], const pointer(&end)[K]) {
+		value_compare cmp;
+		auto win = [&](size_t a, size_t b) {
+			if (end[a] == pos[a])
+				return false;
+			if (end[b] == pos[b])
+				return true;
+			return cmp(*pos[a], *pos[b]) || (a < b && !cmp(*pos[b], *pos[a]));
+		};
+
+		// leaves are K ~ 2K-1, loser[i] is the loser of node i
+		size_t loser[K] = {};
+		size_t winner[K * 2] = {};
+		for (size_t i = 0; i < K; ++i)
+			winner[K + i] = i;
+		for (size_t i = K - 1; i > 0; --i) {
+			const auto a = winner[i * 2];
+			const auto b = winner[i * 2 + 1];
+			if (win(a, b)) {
+				winner[i] = a;
+				loser[i] = b;
+			}
+			else {
+				winner[i] = b;
+				loser[i] = a;
+			}
+		}
+
+		// the winner is empty only if every run is empty
+		for (size_t w = winner[1]; end[w] != pos[w];) {
+			*dst++ = *pos[w]++;
+			for (size_t i = (K + w) / 2; i > 0; i /= 2) {
+				if (win(loser[i], w))
+					std::swap(loser[i], w);
 			}
 		}
 	}
@@ -433,5 +793,337 @@ constexpr auto merge(const Key(&x)[N1], const sorted_array<N2, Key, void, Compar
 	return merge<NewCompare>(y, x);
 }
 
+template<class NewCompare, class Key, class Val, size_t N1, class Compare1, size_t N2, class Compare2, size_t N3, class Compare3, size_t... Ns, class... Compares>
+constexpr auto merge(const sorted_array<N1, Key, Val, Compare1>& x1, const sorted_array<N2, Key, Val, Compare2>& x2, const sorted_array<N3, Key, Val, Compare3>& x3, const sorted_array<Ns, Key, Val, Compares>&... xs)
+{
+	using predicate = typename std::conditional<std::is_same<void, NewCompare>::value, Compare1, NewCompare>::type;
+	using result_type = sorted_array<N1 + N2 + N3 + (Ns + ... + 0), Key, Val, predicate>;
+	using value_type = typename result_type::value_type;
+	using pointer = typename result_type::pointer;
+	constexpr size_t count = 3 + sizeof...(Ns);
+	// inputs sorted by another predicate are sorted again in buf
+	constexpr size_t unsorted = (std::is_same<predicate, Compare1>::value ? 0 : N1)
+		+ (std::is_same<predicate, Compare2>::value ? 0 : N2)
+		+ (std::is_same<predicate, Compare3>::value ? 0 : N3)
+		+ ((std::is_same<predicate, Compares>::value ? 0 : Ns) + ... + 0);
+
+	result_type ret;
+	pointer pos[count] = {};
+	pointer end[count] = {};
+	value_type* buf = unsorted ? new value_type[unsorted] : nullptr;
+	value_type* tmp = buf;
+	size_t n = 0;
+
+	auto add = [&](const auto& x) {
+		if constexpr (std::is_same<predicate, typename std::remove_reference<decltype(x)>::type::key_compare>::value) {
+			pos[n] = x.begin();
+			end[n] = x.end();
+		}
+		else {
+			pos[n] = tmp;
+			for (auto& v : x)
+				*tmp++ = v;
+			end[n] = tmp;
+			result_type::sort(tmp - x.size(), x.size());
+		}
+		++n;
+	};
+	add(x1);
+	add(x2);
+	add(x3);
+	(add(xs), ...);
+
+	result_type::merge_runs(ret.arr_, pos, end);
+	delete[] buf;
+	return ret;
+}
+
+
+// sorted_array stored in BFS (Eytzinger) order
+// arr_[0] is unused, children of arr_[i] are arr_[i * 2] and arr_[i * 2 + 1]
+template<size_t N, class Key, class Val = void, class Compare = std::less<Key>>
+DLOU_REQUIRES(N > 0)
+class eytzinger_array
+{
+public:
+	using key_type = Key;
+	using mapped_type = typename std::conditional<std::is_same<void, Val>::value, Key, Val>::type;
+	using key_compare = Compare;
+	using value_type = typename std::conditional<std::is_same<void, Val>::value, key_type, std::pair<key_type, mapped_type>>::type;
+	using reference = const value_type&;
+	using pointer = const value_type*;
+
+	// in-order iterator
+	class iterator {
+		friend class eytzinger_array;
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = typename eytzinger_array::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = typename eytzinger_array::reference;
+		using pointer = typename eytzinger_array::pointer;
+
+		constexpr iterator() = default;
+
+		constexpr reference operator *() const { return arr_[pos_]; }
+		constexpr pointer operator ->() const { return arr_ + pos_; }
+
+		constexpr iterator& operator ++() {
+			pos_ = _next(pos_);
+			return *this;
+		}
+		constexpr iterator operator ++(int) {
+			auto ret = *this;
+			pos_ = _next(pos_);
+			return ret;
+		}
+		constexpr iterator& operator --() {
+			pos_ = _prev(pos_);
+			return *this;
+		}
+		constexpr iterator operator --(int) {
+			auto ret = *this;
+			pos_ = _prev(pos_);
+			return ret;
+		}
+
+		constexpr bool operator ==(const iterator& x) const { return pos_ == x.pos_; }
+		constexpr bool operator !=(const iterator& x) const { return pos_ != x.pos_; }
+
+	private:
+		constexpr iterator(pointer arr, size_t pos) : arr_(arr), pos_(pos) {}
+
+		pointer arr_ = nullptr;
+		size_t pos_ = 0;
+	};
+	using const_iterator = iterator;
+
+private:
+	template<class K>
+	using transparent_t = std::enable_if_t<is_transparent_v<key_compare>, K>;
+
+	static constexpr size_t cache_line = DLOU_CACHE_LINE;
+	// prefetch the descendants that are log(prefetch_stride) levels below
+	static constexpr size_t prefetch_stride = sizeof(value_type) < cache_line ? base2::floor(cache_line / sizeof(value_type)) : 1;
+
+public:
+	constexpr eytzinger_array(const eytzinger_array&) = default;
+	constexpr eytzinger_array& operator =(const eytzinger_array&) = default;
+
+	constexpr eytzinger_array(const value_type(&x)[N]) {
+		build(sorted_array<N, Key, Val, Compare>(x).data());
+	}
+
+	constexpr eytzinger_array& operator =(const value_type(&x)[N]) {
+		build(sorted_array<N, Key, Val, Compare>(x).data());
+		return *this;
+	}
+
+	// adopt x without sorting, x must be sorted by key_compare
+	constexpr eytzinger_array(presorted_t, const value_type(&x)[N]) {
+		build(x);
+	}
+
+	template<class OldCompare>
+	constexpr eytzinger_array(const sorted_array<N, Key, Val, OldCompare>& x) {
+		clone(x);
+	}
+
+	template<class OldCompare>
+	constexpr eytzinger_array& operator =(const sorted_array<N, Key, Val, OldCompare>& x) {
+		clone(x);
+		return *this;
+	}
+
+	constexpr size_t size() const { return N; }
+	// BFS order
+	constexpr pointer data() const { return arr_ + 1; }
+	constexpr iterator begin() const { return { arr_, leftmost }; }
+	constexpr iterator end() const { return { arr_, 0 }; }
+
+	constexpr const mapped_type& operator [](const key_type& k) const { return get_val(arr_[_find(k)]); }
+
+	constexpr const mapped_type& at(const key_type& k, const mapped_type& invalid = mapped_type{}) const {
+		return _at(k, invalid);
+	}
+
+	constexpr iterator find(const key_type& k) const {
+		return { arr_, _find(k) };
+	}
+
+	constexpr iterator lower_bound(const key_type& k) const {
+		return { arr_, _lower_bound(k) };
+	}
+
+	constexpr iterator upper_bound(const key_type& k) const {
+		return { arr_, _upper_bound(k) };
+	}
+
+	constexpr std::pair<iterator, iterator> equal_range(const key_type& k) const {
+		return range(k, k);
+	}
+
+	constexpr std::pair<iterator, iterator> range(const key_type& min_key, const key_type& max_key) const {
+		return { { arr_, _lower_bound(min_key) }, { arr_, _upper_bound(max_key) } };
+	}
+
+	// transparent key_compare
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& operator [](const K& k) const { return get_val(arr_[_find(k)]); }
+
+	template<class K, class = transparent_t<K>>
+	constexpr const mapped_type& at(const K& k, const mapped_type& invalid = mapped_type{}) const {
+		return _at(k, invalid);
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr iterator find(const K& k) const {
+		return { arr_, _find(k) };
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr iterator lower_bound(const K& k) const {
+		return { arr_, _lower_bound(k) };
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr iterator upper_bound(const K& k) const {
+		return { arr_, _upper_bound(k) };
+	}
+
+	template<class K, class = transparent_t<K>>
+	constexpr std::pair<iterator, iterator> equal_range(const K& k) const {
+		return range(k, k);
+	}
+
+	template<class K1, class K2, class = transparent_t<K1>, class = transparent_t<K2>>
+	constexpr std::pair<iterator, iterator> range(const K1& min_key, const K2& max_key) const {
+		return { { arr_, _lower_bound(min_key) }, { arr_, _upper_bound(max_key) } };
+	}
+
+private:
+	// first / last node of in-order
+	static constexpr size_t leftmost = base2::floor(N);
+	static constexpr size_t rightmost = base2::floor(N + 1) - 1;
+
+	static constexpr size_t _next(size_t i) {
+		if (i * 2 + 1 <= N) {
+			i = i * 2 + 1;
+			while (i * 2 <= N)
+				i *= 2;
+			return i;
+		}
+		// climb while i is right child
+		return i >> (bit::bsf(~i) + 1);
+	}
+
+	static constexpr size_t _prev(size_t i) {
+		if (!i)
+			return rightmost;
+		if (i * 2 <= N) {
+			i *= 2;
+			while (i * 2 + 1 <= N)
+				i = i * 2 + 1;
+			return i;
+		}
+		// climb while i is left child
+		return i >> (bit::bsf(i) + 1);
+	}
+
+	constexpr void prefetch(size_t i) const {
+		if DLOU_IS_CONSTEVAL {
+		}
+		else {
+			i *= prefetch_stride;
+			if (i <= N)
+				DLOU_PREFETCH(arr_ + i);
+		}
+	}
+
+	// return 0 if not found
+	template<class K>
+	constexpr size_t _lower_bound(const K& k) const {
+		Compare cmp;
+		size_t i = 1;
+		while (i <= N) {
+			prefetch(i);
+			i = i * 2 + cmp(get_key(arr_[i]), k);
+		}
+		// cancel the right turns after the last left turn
+		return i >> (bit::bsf(~i) + 1);
+	}
+
+	template<class K>
+	constexpr size_t _upper_bound(const K& k) const {
+		Compare cmp;
+		size_t i = 1;
+		while (i <= N) {
+			prefetch(i);
+			i = i * 2 + !cmp(k, get_key(arr_[i]));
+		}
+		return i >> (bit::bsf(~i) + 1);
+	}
+
+	template<class K>
+	constexpr size_t _find(const K& k) const {
+		auto ret = _lower_bound(k);
+		if (!ret || Compare{}(k, get_key(arr_[ret])))
+			return 0;
+		return ret;
+	}
+
+	template<class K>
+	constexpr const mapped_type& _at(const K& k, const mapped_type& invalid) const {
+		auto ret = _find(k);
+		if (!ret)
+			return invalid;
+		return get_val(arr_[ret]);
+	}
+
+	template<class OldCompare>
+	constexpr void clone(const sorted_array<N, Key, Val, OldCompare>& x) {
+		if constexpr (std::is_same<Compare, OldCompare>::value)
+			build(x.data());
+		else
+			build(sorted_array<N, Key, Val, Compare>(x).data());
+	}
+
+	// p: sorted values
+	constexpr void build(const value_type* p) {
+		arr_[0] = value_type{};
+		for (size_t i = leftmost; i; i = _next(i))
+			arr_[i] = *p++;
+	}
+
+	static constexpr const key_type& get_key(const value_type& v) {
+		if constexpr (std::is_same<void, Val>::value)
+			return v;
+		else
+			return v.first;
+	}
+	static constexpr const mapped_type& get_val(const value_type& v) {
+		if constexpr (std::is_same<void, Val>::value)
+			return v;
+		else
+			return v.second;
+	}
+
+private:
+	value_type arr_[N + 1];
+};
+
+template<class T, class Compare = std::less<T>, size_t N>
+constexpr auto make_eytzinger_set(const T(&arr)[N])
+{
+	return eytzinger_array<N, typename std::remove_reference<T>::type, void, Compare>{arr};
+}
+
+template<class Key, class Val, class Compare = std::less<Key>, size_t N>
+DLOU_REQUIRES(!std::is_same<void, Val>::value)
+constexpr auto make_eytzinger_map(const std::pair<Key, Val>(&arr)[N])
+{
+	return eytzinger_array<N, typename std::remove_reference<Key>::type, typename std::remove_reference<Val>::type, Compare>{arr};
+}
+
 
 } // namespace dlou
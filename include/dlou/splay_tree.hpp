@@ -4,11 +4,11 @@
 
 namespace dlou {
 	
-template<class Key, class Compare = std::less<Key>>
+template<class Key, class Compare = std::less<Key>, class Augment = void>
 class splay_tree
-	: public basic_bst<Key, Compare, void>
+	: public basic_bst<Key, Compare, void, Augment>
 {
-	using basic_type = basic_bst<Key, Compare, void>;
+	using basic_type = basic_bst<Key, Compare, void, Augment>;
 public:
 	using typename basic_type::key_type;
 	using typename basic_type::node;
@@ -22,6 +22,7 @@ protected:
 	using basic_type::root_;
 	using basic_type::_parent;
 	using basic_type::_rotate;
+	using basic_type::_update;
 	using basic_type::make_iterator;
 
 protected:
@@ -55,6 +56,12 @@ protected:
 
 				pos->n[gleft] = grand;
 				_parent(grand) = pos;
+
+				// pos takes the whole subtree of grand
+				if constexpr (!std::is_void_v<typename basic_type::augment_type>) {
+					pos->b.a = grand->b.a;
+					_update(grand);
+				}
 			}
 
 			if (_parent(pos) = nxt)
@@ -97,6 +104,7 @@ public:
 
 				_parent(root_) = sub;
 				sub->n[0] = root_;
+				_update(sub);
 
 				root_ = sub;
 			}
@@ -143,6 +151,7 @@ public:
 			splay(root);
 			root->n[0] = sub.root_;
 			_parent(sub.root_) = root;
+			_update(root);
 			sub.root_ = nullptr;
 		}
 	}
@@ -159,6 +168,7 @@ public:
 			splay(root);
 			root->n[1] = sub.root_;
 			_parent(sub.root_) = root;
+			_update(root);
 			sub.root_ = nullptr;
 		}
 	}
@@ -169,6 +179,7 @@ public:
 		if (root_ = curr->n[0])
 			_parent(root_) = nullptr;
 		curr->n[0] = nullptr;
+		_update(curr);
 
 		return { curr };
 	}
@@ -2,10 +2,13 @@
 
 #include "macro.hpp"
 #include "static.hpp"
+#include "node.hpp"
 #include "singly_linked_list.hpp"
 
 #include <cstddef>
+#include <cstdint>
 
+#include <atomic>
 #include <type_traits>
 #ifdef __cpp_concepts
 #include <concepts>
@@ -31,6 +34,38 @@ namespace _stack {
 		{ list.pop_front() } -> std::same_as<typename Container::node*>;
 	};
 #endif//__cpp_concepts
+
+	// node pointer and ABA tag packed in one lock-free word
+	// 64-bit: user space addresses fit in the low 48 bits, the high 16 bits are the tag
+	// 32-bit: the pointer and a 32-bit tag
+#if UINTPTR_MAX > 0xFFFFFFFFu
+	using tagged_t = uintptr_t;
+	static constexpr tagged_t ptr_mask = (tagged_t(1) << 48) - 1;
+#else
+	using tagged_t = uint64_t;
+	static constexpr tagged_t ptr_mask = 0xFFFFFFFFu;
+#endif
+
+	template<class Node>
+	Node* tagged_ptr(tagged_t v) {
+		return reinterpret_cast<Node*>(static_cast<uintptr_t>(v & ptr_mask));
+	}
+
+	// false if p uses the bits of the tag, such as a top-byte tagged pointer or a 57-bit address
+	template<class Node>
+	bool fits_tagged(Node* p) {
+		return !(static_cast<tagged_t>(reinterpret_cast<uintptr_t>(p)) & ~ptr_mask);
+	}
+
+	template<class Node>
+	tagged_t make_tagged(Node* p, tagged_t tag) {
+		return static_cast<tagged_t>(reinterpret_cast<uintptr_t>(p)) | (tag & ~ptr_mask);
+	}
+
+	// the tag of v plus one, wraps around
+	inline tagged_t next_tag(tagged_t v) {
+		return (v & ~ptr_mask) + (ptr_mask + 1);
+	}
 } // namespace _stack
 
 
@@ -79,4 +114,91 @@ private:
 	container_type list_;
 };
 
+
+// lock-free intrusive stack (Treiber) for any number of threads
+// every pop advances a tag packed with the top pointer, so a stale compare-and-swap fails (ABA)
+// pop reads the link of an object that another thread may have popped meanwhile,
+// so popped objects may be reused but their memory must stay readable while the stack is in use
+template<auto MemberObjPtr>
+DLOU_REQUIRES(
+	std::is_member_object_pointer_v<decltype(MemberObjPtr)>&& MemberObjPtr != nullptr &&
+	std::is_same_v<node<1>, _stack::node_t<MemberObjPtr>>)
+class concurrent_stack
+{
+public:
+	using member_object_type = decltype(MemberObjPtr);
+	using value_type = remove_member_t<member_object_type>;
+	using node = member_t<member_object_type>;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+
+protected:
+	static node* to_node(const_pointer p) {
+		return &(const_cast<pointer>(p)->*MemberObjPtr);
+	}
+
+	static pointer to_object(const node* p) {
+		return (pointer)((char*)p - (ptrdiff_t)(&(((pointer)0)->*MemberObjPtr)));
+	}
+
+public:
+	// the object below p in a chain returned by pop_all, nullptr at the bottom
+	static pointer next(const_pointer p) {
+		node* nxt = to_node(p)->n[0];
+		return nxt ? to_object(nxt) : nullptr;
+	}
+
+public:
+	concurrent_stack() = default;
+	concurrent_stack(const concurrent_stack&) = delete;
+	concurrent_stack& operator =(const concurrent_stack&) = delete;
+
+	bool empty() const {
+		return !_stack::tagged_ptr<node>(head_.load(std::memory_order_acquire));
+	}
+
+	void push(pointer p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p || !_stack::fits_tagged(to_node(p)))
+			return;
+#endif
+		node* nod = to_node(p);
+		auto top = head_.load(std::memory_order_relaxed);
+		do {
+			_node::atomic_next(nod).store(_stack::tagged_ptr<node>(top), std::memory_order_relaxed);
+		} while (!head_.compare_exchange_weak(top, _stack::make_tagged(nod, top)
+			, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	// Return nullptr if empty
+	pointer pop() {
+		auto top = head_.load(std::memory_order_acquire);
+		node* nod;
+		do {
+			nod = _stack::tagged_ptr<node>(top);
+			if (!nod)
+				return nullptr;
+		} while (!head_.compare_exchange_weak(top
+			, _stack::make_tagged(_node::atomic_next(nod).load(std::memory_order_relaxed), _stack::next_tag(top))
+			, std::memory_order_acquire, std::memory_order_acquire));
+		return to_object(nod);
+	}
+
+	// Detach all objects at once
+	// Return the top object, walk down with next(p) ; nullptr if empty
+	//   ex: for (auto p = s.pop_all(); p; p = s.next(p))
+	pointer pop_all() {
+		auto top = head_.load(std::memory_order_relaxed);
+		while (_stack::tagged_ptr<node>(top) && !head_.compare_exchange_weak(top, _stack::next_tag(top)
+			, std::memory_order_acquire, std::memory_order_relaxed));
+		node* nod = _stack::tagged_ptr<node>(top);
+		return nod ? to_object(nod) : nullptr;
+	}
+
+private:
+	alignas(DLOU_CACHE_LINE) std::atomic<_stack::tagged_t> head_{ 0 };
+};
+
 } // namespace dlou
@@ -34,6 +34,17 @@ struct remove_member<M T::*> {
 template<class T>
 using remove_member_t = typename remove_member<T>::type;
 
+template<class T, class = void>
+struct is_transparent : std::false_type {
+};
+
+template<class T>
+struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {
+};
+
+template<class T>
+static constexpr bool is_transparent_v = is_transparent<T>::value;
+
 template<auto MemberObjPtr>
 class mem_obj
 {
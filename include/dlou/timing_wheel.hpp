@@ -0,0 +1,199 @@
+#pragma once
+
+#include "node.hpp"
+#include "integer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <type_traits>
+#include <functional>
+
+namespace dlou {
+
+template<class Key>
+using timing_wheel_node = node<1, Key>;
+
+// hierarchical timing wheel, a monotone min-heap of unsigned integer deadlines
+// a deadline must not be less than now()
+// level l has 64 slots of 2^(6l) ticks, a node sits on the level of the highest bit differing from now()
+// level 0 slots hold exact deadlines, pop cascades the earliest slot of the lowest level when level 0 runs out
+// and moves now() to the popped deadline
+template<class NodeKey
+	, class GetKey = node_key<timing_wheel_node<NodeKey>>>
+class basic_timing_wheel
+	: private GetKey
+{
+public:
+	using node = timing_wheel_node<NodeKey>;
+	using key_type = std::remove_cvref_t<std::invoke_result_t<GetKey, const node&>>;
+	using key_compare = std::less<key_type>;
+
+	static_assert(std::is_unsigned_v<key_type> && sizeof(key_type) <= sizeof(uint64_t), "timing_wheel requires an unsigned integer key");
+
+	static constexpr uint8_t slot_bits = 6;
+	static constexpr size_t slot_count = size_t(1) << slot_bits;
+	static constexpr size_t level_count = (sizeof(key_type) * 8 + slot_bits - 1) / slot_bits;
+
+protected:
+	basic_timing_wheel(const basic_timing_wheel&) = default;
+	basic_timing_wheel& operator =(const basic_timing_wheel&) = default;
+
+	basic_timing_wheel& operator =(basic_timing_wheel&& x) {
+		*this = x;
+		x.clear();
+		return *this;
+	}
+
+	void clear() {
+		for (auto& level : slot_)
+			for (auto& s : level)
+				s = nullptr;
+		for (auto& m : mask_)
+			m = 0;
+		size_ = 0;
+		now_ = 0;
+	}
+
+	const key_type& key(const node& n) const {
+		return GetKey::operator ()(n);
+	}
+
+	const node* min_of(const node* p) const {
+		const node* ret = p;
+		for (p = p->n[0]; p; p = p->n[0]) {
+			if (key(*p) < key(*ret))
+				ret = p;
+		}
+		return ret;
+	}
+
+	// the lowest non-empty level above 0
+	size_t upper_level() const {
+		size_t l = 1;
+		while (!mask_[l])
+			++l;
+		return l;
+	}
+
+	void link(node* p) {
+		const key_type k = key(*p);
+		const size_t l = k == now_ ? 0 : bit::bsr(k ^ now_) / slot_bits;
+		const size_t s = static_cast<size_t>(k >> (l * slot_bits)) & (slot_count - 1);
+		p->n[0] = slot_[l][s];
+		slot_[l][s] = p;
+		mask_[l] |= uint64_t(1) << s;
+	}
+
+	// move the earliest slot of the lowest non-empty level down, its earliest deadline becomes now()
+	void cascade() {
+		const auto l = upper_level();
+		const auto s = bit::bsf(mask_[l]);
+		mask_[l] &= mask_[l] - 1;
+		node* p = slot_[l][s];
+		slot_[l][s] = nullptr;
+
+		now_ = key(*min_of(p));
+		while (p) {
+			node* nxt = p->n[0];
+			link(p);
+			p = nxt;
+		}
+	}
+
+public:
+	basic_timing_wheel() {
+		clear();
+	}
+
+	basic_timing_wheel(basic_timing_wheel&& x)
+		: basic_timing_wheel(x) {
+		x.clear();
+	}
+
+	void swap(basic_timing_wheel& x) {
+		auto tmp = *this;
+		*this = x;
+		x = tmp;
+	}
+
+	bool empty() const {
+		return !size_;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	// the current time, a lower bound of all deadlines
+	// merge takes the earlier one
+	key_type now() const {
+		return now_;
+	}
+
+	// O(size of the wheel with the later now())
+	void merge(basic_timing_wheel& x) {
+		if (x.empty())
+			return;
+		if (empty() || x.now_ < now_)
+			swap(x);
+
+		size_ += x.size_;
+		for (size_t l = 0; l != level_count; ++l) {
+			for (auto m = x.mask_[l]; m; m &= m - 1) {
+				for (node* p = x.slot_[l][bit::bsf(m)]; p; ) {
+					node* nxt = p->n[0];
+					link(p);
+					p = nxt;
+				}
+			}
+		}
+		x.clear();
+	}
+
+	// O(1) if the top is on level 0, otherwise scan the earliest slot of the lowest level
+	const node* peek() const {
+		if (mask_[0])
+			return slot_[0][bit::bsf(mask_[0])];
+		if (empty())
+			return nullptr;
+		const auto l = upper_level();
+		return min_of(slot_[l][bit::bsf(mask_[l])]);
+	}
+
+	void push(node* p) {
+#ifdef DLOU_CHECK_ARGS
+		if (!p || key(*p) < now_)
+			return;
+#endif
+		link(p);
+		++size_;
+	}
+
+	node* pop() {
+#ifdef DLOU_CHECK_ARGS
+		if (empty())
+			return nullptr;
+#endif
+		if (!mask_[0])
+			cascade();
+		const auto s = bit::bsf(mask_[0]);
+		node* ret = slot_[0][s];
+		if (!(slot_[0][s] = ret->n[0]))
+			mask_[0] &= mask_[0] - 1;
+		--size_;
+		return ret;
+	}
+
+protected:
+	node* slot_[level_count][slot_count];
+	// bit s of mask_[l] : slot_[l][s] is not empty
+	uint64_t mask_[level_count];
+	size_t size_;
+	key_type now_;
+};
+
+template<class Key>
+using timing_wheel = basic_timing_wheel<Key, node_key<timing_wheel_node<Key>>>;
+
+} // namespace dlou
@@ -7,18 +7,18 @@
 
 namespace dlou {
 
-template<class Key, class Compare = std::less<Key>, class Random = std::random_device>
+template<class Key, class Compare = std::less<Key>, class Random = std::random_device, class Augment = void>
 class treap
-	: public basic_bst<Key, Compare, unsigned>
+	: public basic_bst<Key, Compare, unsigned, Augment>
 {
-	using basic_type = basic_bst<Key, Compare, unsigned>;
+	using basic_type = basic_bst<Key, Compare, unsigned, Augment>;
 public:
 	using typename basic_type::key_type;
 	using typename basic_type::node;
 	using typename basic_type::iterator;
 
 	using random_engine = Random;
-	using priority_type = node_balance_t<node>;
+	using priority_type = typename basic_type::balance_type;
 
 protected:
 	using basic_type::root_;
@@ -34,7 +34,7 @@ protected:
 	}
 	random_engine rand_;
 
-	static priority_type& priority(const node* p) { return const_cast<priority_type&>(p->b); }
+	static priority_type& priority(const node* p) { return const_cast<priority_type&>(basic_type::balance(p)); }
 
 protected:
 	bool _fault(const node* pos) const {
@@ -54,7 +54,7 @@ protected:
 				return true;
 		}
 
-		return false;
+		return basic_type::_fault_augment(pos);
 	}
 
 public:
@@ -123,6 +123,8 @@ public:
 		else
 			root_ = child;
 
+		basic_type::_update_path(parent);
+
 		return const_cast<node*>(pos);
 	}
 